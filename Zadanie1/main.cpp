@@ -11,8 +11,15 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <string>
 
 #include "shaders.h"
+#include "mesh.h"
+#include "buffers.h"
+#include "perf.h"
+#include "uniforms.h"
+#include "statecache.h"
+#include "renderqueue.h"
 
 
 const int V_MAX = 12;
@@ -21,57 +28,106 @@ const int U_MAX = 16;
 const float RADIUS = 1.0f;
 const float Z_MIN = -1.0f;
 const float Z_MAX = 1.0f;
-const float THETA_MAX = 360.0f * ((float)M_PI / 180);
+
+// sposoby rysowania siatki przelaczane klawiszem F2
+enum WireframeMode { WIREFRAME_POLYGON, WIREFRAME_EDGES, WIREFRAME_BARYCENTRIC, WIREFRAME_MODES };
+
+// ksztalty wybierane klawiszami 1-6
+enum Shape { SHAPE_SPHERE, SHAPE_ELLIPSOID, SHAPE_TORUS, SHAPE_CYLINDER, SHAPE_CONE, SHAPE_SUPERQUADRIC };
+
+const Sphere SPHERE = { RADIUS, Z_MIN, Z_MAX };
+const Ellipsoid ELLIPSOID = { glm::vec3(1.0f, 0.7f, 0.5f) };
+const Torus TORUS = { 0.7f, 0.3f };
+const Cylinder CYLINDER = { 0.6f, -1.0f, 1.0f };
+const Cone CONE = { 0.8f, 1.5f };
+const Superquadric SUPERQUADRIC = { glm::vec3(0.8f), 0.3f, 0.3f };
 
 
 constexpr int WIDTH = 600; // szerokosc okna
 constexpr int HEIGHT = 600; // wysokosc okna
 constexpr float ROT_STEP = 15.0f; // kat obrotu (w stopniach)
 constexpr float ZOOM_FACTOR = 1.1f; // wspolczynnik do zmiany kata fovy
+constexpr int V_LIMIT = 2048; // maksymalna liczba podzialow w kierunku fi
+constexpr int U_LIMIT = 4096; // maksymalna liczba podzialow w kierunku theta
+constexpr int BENCHMARK_FRAMES = 100; // liczba klatek mierzonych dla kazdego wariantu w trybie --benchmark
 
 //******************************************************************************************
-GLuint vao; // identyfikatory VAO
-GLuint buffers[2]; // identyfikatory VBO
+GLuint vao[2]; // identyfikatory VAO (trojkaty, krawedzie)
+GLuint buffers[3]; // identyfikatory VBO (wierzcholki, indeksy trojkatow, indeksy krawedzi)
 
 GLuint shaderProgram; // identyfikator programu cieniowania
+GLuint wireframeProgram; // identyfikator programu cieniowania rysujacego wypelnienie z krawedziami w jednym przebiegu
 
 GLuint vertexLoc; // lokalizacja atrybutu wierzcholka - wspolrzedne wierzcholkow
-GLuint colorLoc; // lokalizacja zmiennej jednorodnej - kolor rysowania prymitywu
 
-GLuint projMatrixLoc; // lokalizacja zmiennej jednorodnej - macierz projekcji
-GLuint mvMatrixLoc; // lokalizacja zmiennej jednorodnej - macierz model-widok
+UniformBlocks uniformBlocks; // bufory UBO z danymi klatki (FrameBlock) i obiektu (ObjectBlock)
+bool frameChanged = true; // czy dane klatki trzeba zapisac ponownie do UBO
+bool objectChanged = true; // czy dane obiektu (macierz MVP) trzeba zapisac ponownie do UBO
+StateCache glState; // pamiec podreczna stanu OpenGL - pomija wywolania, ktore nic nie zmieniaja
+RenderQueue renderQueue; // kolejka rysowania sortowana wedlug stanu
 
 glm::mat4 projMatrix; // macierz projekcji
+glm::mat4 viewMatrix; // macierz widoku
 glm::mat4 mvMatrix; // macierz model-widok
 
 bool wireframe = true; // czy rysowac siatke (true) czy wypelnienie (false)
+WireframeMode wireframeMode = WIREFRAME_POLYGON; // sposob rysowania siatki
 glm::vec3 rotationAngles = glm::vec3(0.0, 0.0, 0.0); // katy rotacji wokol poszczegolnych osi
 float fovy = 15.0f; // kat patrzenia (uzywany do skalowania sceny)
 float aspectRatio = static_cast<float>(WIDTH) / HEIGHT;
 
 GLint indicesNumber = 0; // liczba indeksow definiujacych obiekt
+GLint edgesNumber = 0; // liczba indeksow krawedzi (0 - bufor krawedzi jeszcze nie utworzony)
 
 float color[] = { 0.0f, 1.0f, 0.0f, 1.0f }; // kolor jakim rysowac siatke
+float fillColor[] = { 0.0f, 0.2f, 0.0f, 1.0f }; // kolor wypelnienia pod siatka (WIREFRAME_BARYCENTRIC)
 float lineWidth = 1.5f; // grubosc linii
+
+Shape shape = SHAPE_SPHERE; // aktualnie rysowany ksztalt
+int vMax = V_MAX; // aktualna liczba podzialow w kierunku fi
+int uMax = U_MAX; // aktualna liczba podzialow w kierunku theta
+
+bool stagedUpload = false; // czy generowac siatke do wektorow i kopiowac przez glBufferData (--staged, do porownan)
+bool persistentMapping = true; // czy uzywac trwale zmapowanego bufora danych obiektow (--no-persistent wylacza)
+bool benchmark = false; // czy uruchomic pomiar wydajnosci trybow siatki i zakonczyc program (--benchmark)
+
+GpuTimer gpuTimer; // pomiar czasu rysowania na GPU
 //******************************************************************************************
 
 void errorCallback(int error, const char* description);
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 void framebufferSizeCallback(GLFWwindow* window, int width, int height);
 void updateProjectionMatrix();
+void updateModelViewMatrix();
 void onShutdown();
 void initGL();
 void setupShaders();
 void setupBuffers();
+void setupEdgeBuffer();
 void renderScene();
+void runBenchmark(GLFWwindow* window);
 
-void generateSphereVertices(std::vector<float> &vertices);
-void generateSphereIndices(std::vector<unsigned int> &vertices);
+void generateShapeVertices(float* vertices);
+bool shapeHasPoles();
+void changeShape(Shape newShape);
+void changeTessellation(int newVMax, int newUMax);
+void changeWireframeMode(WireframeMode newMode);
+void rebuildBuffers();
 
 int main(int argc, char* argv[])
 {
 	atexit(onShutdown);
 
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--staged")
+			stagedUpload = true;
+		else if (std::string(argv[i]) == "--benchmark")
+			benchmark = true;
+		else if (std::string(argv[i]) == "--no-persistent")
+			persistentMapping = false;
+	}
+
 	GLFWwindow* window;
 
 	glfwSetErrorCallback(errorCallback);
@@ -110,10 +166,16 @@ int main(int argc, char* argv[])
 		exit(2);
 	}
 
-	glfwSwapInterval(1); // v-sync on
+	glfwSwapInterval(benchmark ? 0 : 1); // v-sync on (wylaczony podczas pomiarow)
 
 	initGL();
 
+	if (benchmark)
+	{
+		runBenchmark(window);
+		glfwSetWindowShouldClose(window, GLFW_TRUE);
+	}
+
 	while (!glfwWindowShouldClose(window))
 	{
 		renderScene();
@@ -161,36 +223,42 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 			rotationAngles.x -= ROT_STEP;
 			if (rotationAngles.x < 0.0f)
 				rotationAngles.x += 360.0f;
+			updateModelViewMatrix();
 			break;
 
 		case GLFW_KEY_S:
 			rotationAngles.x += ROT_STEP;
 			if (rotationAngles.x > 360.0f)
 				rotationAngles.x -= 360.0f;
+			updateModelViewMatrix();
 			break;
 
 		case GLFW_KEY_A:
 			rotationAngles.y -= ROT_STEP;
 			if (rotationAngles.y < 0.0f)
 				rotationAngles.y += 360.0f;
+			updateModelViewMatrix();
 			break;
 
 		case GLFW_KEY_D:
 			rotationAngles.y += ROT_STEP;
 			if (rotationAngles.y > 360.0f)
 				rotationAngles.y -= 360.0f;
+			updateModelViewMatrix();
 			break;
 
 		case GLFW_KEY_E:
 			rotationAngles.z -= ROT_STEP;
 			if (rotationAngles.z < 0.0f)
 				rotationAngles.z += 360.f;
+			updateModelViewMatrix();
 			break;
 
 		case GLFW_KEY_Q:
 			rotationAngles.z += ROT_STEP;
 			if (rotationAngles.z > 360.0f)
 				rotationAngles.z -= 360.0f;
+			updateModelViewMatrix();
 			break;
 
 		case GLFW_KEY_EQUAL: // =
@@ -211,6 +279,27 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 		case GLFW_KEY_F1:
 			wireframe = !wireframe;
 			break;
+
+		case GLFW_KEY_F2:
+			changeWireframeMode(static_cast<WireframeMode>((wireframeMode + 1) % WIREFRAME_MODES));
+			break;
+
+		case GLFW_KEY_1:
+		case GLFW_KEY_2:
+		case GLFW_KEY_3:
+		case GLFW_KEY_4:
+		case GLFW_KEY_5:
+		case GLFW_KEY_6:
+			changeShape(static_cast<Shape>(key - GLFW_KEY_1));
+			break;
+
+		case GLFW_KEY_RIGHT_BRACKET: // ] - gestsza siatka
+			changeTessellation(2 * vMax, 2 * uMax);
+			break;
+
+		case GLFW_KEY_LEFT_BRACKET: // [ - rzadsza siatka
+			changeTessellation(vMax / 2, uMax / 2);
+			break;
 		}
 	}
 }
@@ -235,6 +324,19 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height)
 void updateProjectionMatrix()
 {
 	projMatrix = glm::perspective(glm::radians(fovy), aspectRatio, 0.1f, 100.0f);
+	frameChanged = true;
+	objectChanged = true; // macierz MVP zawiera macierz projekcji
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja aktualizuje macierz model-widok po zmianie katow rotacji
+**------------------------------------------------------------------------------------------*/
+void updateModelViewMatrix()
+{
+	mvMatrix = glm::rotate(viewMatrix, glm::radians(rotationAngles.z), glm::vec3(0.0f, 0.0f, 1.0f));
+	mvMatrix = glm::rotate(mvMatrix, glm::radians(rotationAngles.y), glm::vec3(0.0f, 1.0f, 0.0f));
+	mvMatrix = glm::rotate(mvMatrix, glm::radians(rotationAngles.x), glm::vec3(1.0f, 0.0f, 0.0f));
+	objectChanged = true;
 }
 
 /*------------------------------------------------------------------------------------------
@@ -242,9 +344,14 @@ void updateProjectionMatrix()
 **------------------------------------------------------------------------------------------*/
 void onShutdown()
 {
-	glDeleteBuffers(2, buffers);
-	glDeleteVertexArrays(1, &vao);
+	glDeleteBuffers(3, buffers);
+	glDeleteVertexArrays(2, vao);
 	glDeleteProgram(shaderProgram);
+	glDeleteProgram(wireframeProgram);
+	uniformBlocks.destroy();
+	gpuTimer.destroy();
+
+	glState.printStats("Stan OpenGL");
 }
 
 /*------------------------------------------------------------------------------------------
@@ -262,10 +369,16 @@ void initGL()
 	glEnable(GL_DEPTH_TEST);
 
 	updateProjectionMatrix();
+	viewMatrix = glm::lookAt(glm::vec3(0, 0, 8), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+	updateModelViewMatrix();
+
+	uniformBlocks.init(1, persistentMapping);
 
 	setupShaders();
 
 	setupBuffers();
+
+	gpuTimer.init();
 }
 
 /*------------------------------------------------------------------------------------------
@@ -277,10 +390,12 @@ void setupShaders()
 		exit(3);
 
 	vertexLoc = glGetAttribLocation(shaderProgram, "vPosition");
-	colorLoc = glGetUniformLocation(shaderProgram, "color");
 
-	projMatrixLoc = glGetUniformLocation(shaderProgram, "projectionMatrix");
-	mvMatrixLoc = glGetUniformLocation(shaderProgram, "modelViewMatrix");
+	if (!setupShaders("shaders/vertex.vert", "shaders/wireframe.geom", "shaders/wireframe.frag", wireframeProgram))
+		exit(3);
+
+	uniformBlocks.bindProgram(shaderProgram);
+	uniformBlocks.bindProgram(wireframeProgram);
 }
 
 /*------------------------------------------------------------------------------------------
@@ -288,31 +403,94 @@ void setupShaders()
 **------------------------------------------------------------------------------------------*/
 void setupBuffers()
 {
-	std::vector<float> vertices;
+	Stopwatch stopwatch;
+
+	const int verticesNumber = surfaceVertexCount(vMax, uMax);
+	indicesNumber = surfaceIndexCount(vMax, uMax, shapeHasPoles());
+
+	const GLsizeiptr verticesSize = 4 * verticesNumber * sizeof(float);
+	const GLsizeiptr indicesSize = indicesNumber * sizeof(unsigned int);
+
+	glGenVertexArrays(2, vao);
+	glBindVertexArray(vao[0]);
 
-	generateSphereVertices(vertices);
+	glGenBuffers(3, buffers);
 
-	std::vector<unsigned int> indices;
+	if (stagedUpload)
+	{
+		std::vector<float> vertices(4 * verticesNumber);
+		generateShapeVertices(vertices.data());
 
-	generateSphereIndices(indices);
+		std::vector<unsigned int> indices(indicesNumber);
+		generateSurfaceIndices(vMax, uMax, shapeHasPoles(), indices.data());
 
-	indicesNumber = (GLuint)indices.size();
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+		glBufferData(GL_ARRAY_BUFFER, verticesSize, vertices.data(), GL_STATIC_DRAW);
 
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesSize, indices.data(), GL_STATIC_DRAW);
+	}
+	else
+	{
+		// siatka generowana bezposrednio w zmapowanej pamieci buforow
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+		fillBuffer<float>(GL_ARRAY_BUFFER, verticesSize, generateShapeVertices);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+		fillBuffer<unsigned int>(GL_ELEMENT_ARRAY_BUFFER, indicesSize, [](unsigned int* indices) { generateSurfaceIndices(vMax, uMax, shapeHasPoles(), indices); });
+	}
 
-	glGenBuffers(2, buffers);
 	// VBO dla wierzcholkow
 	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), reinterpret_cast<GLfloat*>(&vertices[0]), GL_STATIC_DRAW);
 	glEnableVertexAttribArray(vertexLoc);
 	glVertexAttribPointer(vertexLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
 
-	// VBO dla indeksow
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), reinterpret_cast<GLuint*>(&indices[0]), GL_STATIC_DRAW);
+	glBindVertexArray(0);
+
+	glFinish(); // czas ladowania obejmuje przeslanie danych do GPU
+	std::cout << "Siatka " << vMax << "x" << uMax << " (" << (stagedUpload ? "glBufferData" : "glMapBufferRange") << "): "
+		<< verticesNumber << " wierzcholkow, " << indicesNumber << " indeksow, " << stopwatch.elapsedMs() << " ms" << std::endl;
+	printMemoryUsage("Siatka");
+
+	edgesNumber = 0;
+	if (wireframeMode == WIREFRAME_EDGES)
+		setupEdgeBuffer();
+
+	glState.invalidate(); // VAO i bufory dowiazywane byly z pominieciem glState
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzaca bufor indeksow unikalnych krawedzi siatki (GL_LINES) oraz VAO do ich
+** rysowania; indeksy trojkatow sa generowane ponownie do pamieci programu, co jest
+** tansze niz odczyt bufora zapisanego w zmapowanej pamieci GPU
+**------------------------------------------------------------------------------------------*/
+void setupEdgeBuffer()
+{
+	Stopwatch stopwatch;
+
+	std::vector<unsigned int> indices(indicesNumber);
+	generateSurfaceIndices(vMax, uMax, shapeHasPoles(), indices.data());
+
+	std::vector<unsigned int> edges;
+	extractEdges(indices.data(), indicesNumber, edges);
+
+	edgesNumber = (GLint)edges.size();
+
+	glBindVertexArray(vao[1]);
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+	glEnableVertexAttribArray(vertexLoc);
+	glVertexAttribPointer(vertexLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
+
+	// VBO dla indeksow krawedzi
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[2]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, edges.size() * sizeof(unsigned int), edges.data(), GL_STATIC_DRAW);
 
 	glBindVertexArray(0);
+
+	glState.invalidate();
+
+	std::cout << "Krawedzie: " << edgesNumber / 2 << " (z " << indicesNumber << " indeksow trojkatow), " << stopwatch.elapsedMs() << " ms" << std::endl;
 }
 
 /*------------------------------------------------------------------------------------------
@@ -322,100 +500,212 @@ void renderScene()
 {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	mvMatrix = glm::lookAt(glm::vec3(0, 0, 8), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
-
-	glUseProgram(shaderProgram);
-	glUniformMatrix4fv(projMatrixLoc, 1, GL_FALSE, glm::value_ptr(projMatrix));
+	if (frameChanged)
+	{
+		const FrameBlock frame = { projMatrix, viewMatrix, lineWidth, {} };
+		uniformBlocks.updateFrame(frame);
+		frameChanged = false;
+	}
 
-	if (wireframe)
+	if (objectChanged) // dane obiektu zapisywane sa tylko po obrocie lub zmianie projekcji
 	{
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		glLineWidth(lineWidth);
+		const ObjectBlock object = { projMatrix * mvMatrix, glm::make_vec4(color), glm::make_vec4(fillColor) };
+		uniformBlocks.updateObjects(&object, 1);
+		objectChanged = false;
 	}
+
+	bool edges = wireframe && wireframeMode == WIREFRAME_EDGES;
+	bool barycentric = wireframe && wireframeMode == WIREFRAME_BARYCENTRIC;
+
+	if (wireframe && wireframeMode == WIREFRAME_POLYGON)
+		glState.polygonMode(GL_LINE);
 	else
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		glState.polygonMode(GL_FILL); // GL_LINES i WIREFRAME_BARYCENTRIC rysowane sa bez trybu GL_LINE
 
-	mvMatrix = glm::rotate(mvMatrix, glm::radians(rotationAngles.z), glm::vec3(0.0f, 0.0f, 1.0f));
-	mvMatrix = glm::rotate(mvMatrix, glm::radians(rotationAngles.y), glm::vec3(0.0f, 1.0f, 0.0f));
-	mvMatrix = glm::rotate(mvMatrix, glm::radians(rotationAngles.x), glm::vec3(1.0f, 0.0f, 0.0f));
+	glState.lineWidth(lineWidth);
 
-	glUniformMatrix4fv(mvMatrixLoc, 1, GL_FALSE, glm::value_ptr(mvMatrix));
+	gpuTimer.begin();
 
-	glBindVertexArray(vao);
-	glUniform4fv(colorLoc, 1, color);
-	glDrawElements(GL_TRIANGLES, indicesNumber, GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
-}
+	RenderCommand command;
 
-void generateSphereVertices(std::vector<float> &vertices)
-{
-	float fi, fiMin, fiMax, theta;
+	// WIREFRAME_BARYCENTRIC - wypelnienie i krawedzie o dowolnej grubosci w jednym przebiegu
+	command.program = barycentric ? wireframeProgram : shaderProgram;
+	command.vertexArray = vao[edges ? 1 : 0]; // VAO zostaje dowiazane do nastepnej klatki
+	command.objectBuffer = uniformBlocks.objectRange(0);
+	command.type = DRAW_ELEMENTS;
+	command.mode = edges ? GL_LINES : GL_TRIANGLES;
+	command.count = edges ? edgesNumber : indicesNumber;
 
-	if (Z_MIN > -RADIUS)
-		fiMin = asin(Z_MIN / RADIUS);
-	else if (Z_MIN <= -RADIUS)
-		fiMin = -90.0f * ((float)M_PI / 180);
+	renderQueue.submit(command);
+	renderQueue.flush(glState);
 
-	if (Z_MAX < RADIUS)
-		fiMax = asin(Z_MAX / RADIUS);
-	else if (Z_MAX >= RADIUS)
-		fiMax = 90.0f * ((float)M_PI / 180);
+	uniformBlocks.endFrame();
+	glState.endFrame();
 
-	const float V_STEP = 1.0f / V_MAX;
-	const float U_STEP = 1.0f / U_MAX;
+	gpuTimer.end();
+}
 
-	float v = 0.0f, u = 0.0f;
+/*------------------------------------------------------------------------------------------
+** funkcja porownuje czas rysowania siatki w trybie glPolygonMode(GL_LINE), jako listy
+** krawedzi (GL_LINES) oraz shaderem barycentrycznym dla coraz gestszych sfer i wyswietla
+** wyniki
+** window - okno, w ktorym rysowana jest scena
+**------------------------------------------------------------------------------------------*/
+void runBenchmark(GLFWwindow* window)
+{
+	const int TESSELLATIONS[][2] = { { 128, 256 }, { 512, 1024 }, { V_LIMIT, U_LIMIT / 2 } };
+	const char* MODE_NAMES[] = { "glPolygonMode(GL_LINE)", "GL_LINES", "barycentric" };
 
-	//std::cout << fiMin << " " << fiMax << ", " << V_STEP << " " << U_STEP << std::endl;
+	wireframe = true;
+	changeShape(SHAPE_SPHERE);
 
-	for (int i = 0; i < V_MAX + 1; i++)
+	for (const auto& tessellation : TESSELLATIONS)
 	{
-		fi = fiMin + v * (fiMax - fiMin);
+		changeTessellation(tessellation[0], tessellation[1]);
 
-		for (int j = 0; j < U_MAX; j++)
+		for (int mode = WIREFRAME_POLYGON; mode < WIREFRAME_MODES; mode++)
 		{
-			theta = u * THETA_MAX;
+			changeWireframeMode(static_cast<WireframeMode>(mode));
+
+			glFinish();
+			gpuTimer.reset();
+			uniformBlocks.objectRing.resetStats();
+			glState.resetStats();
+			Stopwatch stopwatch;
 
-			vertices.push_back(RADIUS * cos(theta) * cos(fi));	// x
-			vertices.push_back(RADIUS * sin(theta) * cos(fi));	// y
-			vertices.push_back(RADIUS * sin(fi));				// z
-			vertices.push_back(1.0f);
+			int frames = 0; // liczba narysowanych klatek (mniej niz BENCHMARK_FRAMES po zamknieciu okna)
+			for (; frames < BENCHMARK_FRAMES && !glfwWindowShouldClose(window); frames++)
+			{
+				renderScene();
+
+				glfwSwapBuffers(window);
+				glfwPollEvents();
+			}
+
+			glFinish();
 
-			u += U_STEP;
+			if (frames == 0)
+				return;
+
+			std::cout << "[benchmark] " << vMax << "x" << uMax << " " << MODE_NAMES[mode] << ": GPU " << gpuTimer.averageMs()
+				<< " ms, klatka " << stopwatch.elapsedMs() / frames << " ms, oczekiwania na GPU " << uniformBlocks.objectRing.stalls << std::endl;
+			glState.printStats("[benchmark] stan OpenGL");
 		}
-		v += V_STEP;
 	}
 }
 
-void generateSphereIndices(std::vector<unsigned int> &indices)
+/*------------------------------------------------------------------------------------------
+** funkcja generujaca wierzcholki aktualnie wybranego ksztaltu
+** vertices - miejsce docelowe na wierzcholki
+**------------------------------------------------------------------------------------------*/
+void generateShapeVertices(float* vertices)
 {
-	int i = 0, j = 0, k;
-
-	while (j < U_MAX)
+	switch (shape)
 	{
-		j++;
-		k = j + 1;
+	case SHAPE_SPHERE:
+		generateSurfaceVertices(SPHERE, vMax, uMax, vertices);
+		break;
 
-		indices.push_back(i); //	0, 0, 0 ...
-		indices.push_back(j); //	1, 2, 3 ...		domkniecie gory
-		indices.push_back(k); //	2, 3, 4 ...
+	case SHAPE_ELLIPSOID:
+		generateSurfaceVertices(ELLIPSOID, vMax, uMax, vertices);
+		break;
 
-		//std::cout << i << " " << j << " " << k << std::endl;
+	case SHAPE_TORUS:
+		generateSurfaceVertices(TORUS, vMax, uMax, vertices);
+		break;
+
+	case SHAPE_CYLINDER:
+		generateSurfaceVertices(CYLINDER, vMax, uMax, vertices);
+		break;
+
+	case SHAPE_CONE:
+		generateSurfaceVertices(CONE, vMax, uMax, vertices);
+		break;
+
+	case SHAPE_SUPERQUADRIC:
+		generateSurfaceVertices(SUPERQUADRIC, vMax, uMax, vertices);
+		break;
 	}
+}
 
-	for (i = 2; i < V_MAX * U_MAX; i++)
+/*------------------------------------------------------------------------------------------
+** funkcja sprawdza, czy siatka aktualnie wybranego ksztaltu domykana jest w biegunie
+**------------------------------------------------------------------------------------------*/
+bool shapeHasPoles()
+{
+	switch (shape)
 	{
-		j++;
-		k = j + 1;
+	case SHAPE_SPHERE:
+		return SPHERE.hasPoles();
 
-		indices.push_back(i); //		  2,	   3,	    4 ...
-		indices.push_back(j); //	  U_MAX, U_MAX+1, U_MAX+2 ...	1/2 quada
-		indices.push_back(k); //	U_MAX+1, U_MAX+2, U_MAX+3 ...
+	case SHAPE_ELLIPSOID:
+		return ELLIPSOID.hasPoles();
 
-		indices.push_back(i); //		  2,	   3,	    4 ...
-		indices.push_back(j); //	  U_MAX, U_MAX+1, U_MAX+2 ...	2/2 quada
-		indices.push_back(i - 1); //	  1,	   2,		3 ...
+	case SHAPE_TORUS:
+		return TORUS.hasPoles();
 
-		//std::cout << i << " " << j << " " << k << std::endl;
+	case SHAPE_CYLINDER:
+		return CYLINDER.hasPoles();
+
+	case SHAPE_CONE:
+		return CONE.hasPoles();
+
+	case SHAPE_SUPERQUADRIC:
+		return SUPERQUADRIC.hasPoles();
 	}
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zmienia rysowany ksztalt i odtwarza bufory z danymi o modelu
+** newShape - nowy ksztalt
+**------------------------------------------------------------------------------------------*/
+void changeShape(Shape newShape)
+{
+	if (newShape == shape)
+		return;
+
+	shape = newShape;
+
+	rebuildBuffers();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zmienia gestosc siatki i odtwarza bufory z danymi o modelu
+** newVMax - nowa liczba podzialow w kierunku fi
+** newUMax - nowa liczba podzialow w kierunku theta
+**------------------------------------------------------------------------------------------*/
+void changeTessellation(int newVMax, int newUMax)
+{
+	if (newVMax < 2 || newUMax < 3 || newVMax > V_LIMIT || newUMax > U_LIMIT)
+		return;
+
+	vMax = newVMax;
+	uMax = newUMax;
+
+	rebuildBuffers();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa i ponownie tworzy VAO oraz VBO z danymi o modelu
+**------------------------------------------------------------------------------------------*/
+void rebuildBuffers()
+{
+	glDeleteBuffers(3, buffers);
+	glDeleteVertexArrays(2, vao);
+
+	setupBuffers();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zmienia sposob rysowania siatki, w razie potrzeby tworzac bufor krawedzi
+** newMode - nowy sposob rysowania siatki
+**------------------------------------------------------------------------------------------*/
+void changeWireframeMode(WireframeMode newMode)
+{
+	wireframeMode = newMode;
+
+	if (wireframeMode == WIREFRAME_EDGES && edgesNumber == 0)
+		setupEdgeBuffer();
 }
\ No newline at end of file
@@ -0,0 +1,309 @@
+#ifndef __MESH_H__
+#define __MESH_H__
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <vector>
+#include <cmath>
+#include <utility>
+
+const float THETA_MAX = glm::two_pi<float>(); // zakres kata theta (wokol osi z)
+
+/*------------------------------------------------------------------------------------------
+** kat wraz z wartosciami funkcji trygonometrycznych - liczone raz dla calego wiersza
+** (fi) lub kolumny (theta) siatki, a nie dla kazdego wierzcholka osobno
+**------------------------------------------------------------------------------------------*/
+struct Angle
+{
+	float value;
+	float cosine;
+	float sine;
+};
+
+inline Angle makeAngle(float value)
+{
+	return { value, std::cos(value), std::sin(value) };
+}
+
+/*------------------------------------------------------------------------------------------
+** powierzchnie parametryczne - kazda definiuje zakres parametru fi (fiMin, fiMax),
+** hasPoles() - czy pierwszy wiersz siatki schodzi sie w biegun (domykany wachlarzem
+** trojkatow), oraz operator() zwracajacy punkt powierzchni dla katow theta i fi
+**------------------------------------------------------------------------------------------*/
+struct Sphere
+{
+	float radius;
+	float zMin;
+	float zMax;
+
+	float fiMin() const { return (zMin > -radius) ? std::asin(zMin / radius) : -glm::half_pi<float>(); }
+	float fiMax() const { return (zMax < radius) ? std::asin(zMax / radius) : glm::half_pi<float>(); }
+	bool hasPoles() const { return true; }
+
+	glm::vec3 operator()(const Angle& theta, const Angle& fi) const
+	{
+		return glm::vec3(radius * theta.cosine * fi.cosine, radius * theta.sine * fi.cosine, radius * fi.sine);
+	}
+};
+
+struct Ellipsoid
+{
+	glm::vec3 radii;
+
+	float fiMin() const { return -glm::half_pi<float>(); }
+	float fiMax() const { return glm::half_pi<float>(); }
+	bool hasPoles() const { return true; }
+
+	glm::vec3 operator()(const Angle& theta, const Angle& fi) const
+	{
+		return radii * glm::vec3(theta.cosine * fi.cosine, theta.sine * fi.cosine, fi.sine);
+	}
+};
+
+struct Torus
+{
+	float majorRadius; // odleglosc srodka rury od srodka torusa
+	float minorRadius; // promien rury
+
+	float fiMin() const { return 0.0f; }
+	float fiMax() const { return glm::two_pi<float>(); }
+	bool hasPoles() const { return false; }
+
+	glm::vec3 operator()(const Angle& theta, const Angle& fi) const
+	{
+		float r = majorRadius + minorRadius * fi.cosine;
+		return glm::vec3(r * theta.cosine, r * theta.sine, minorRadius * fi.sine);
+	}
+};
+
+struct Cylinder // fi jest tu wysokoscia z
+{
+	float radius;
+	float zMin;
+	float zMax;
+
+	float fiMin() const { return zMin; }
+	float fiMax() const { return zMax; }
+	bool hasPoles() const { return false; }
+
+	glm::vec3 operator()(const Angle& theta, const Angle& fi) const
+	{
+		return glm::vec3(radius * theta.cosine, radius * theta.sine, fi.value);
+	}
+};
+
+struct Cone // fi jest tu wysokoscia z, wierzcholek stozka w z = height
+{
+	float radius;
+	float height;
+
+	float fiMin() const { return 0.0f; }
+	float fiMax() const { return height; }
+	bool hasPoles() const { return false; }
+
+	glm::vec3 operator()(const Angle& theta, const Angle& fi) const
+	{
+		float r = radius * (1.0f - fi.value / height);
+		return glm::vec3(r * theta.cosine, r * theta.sine, fi.value);
+	}
+};
+
+struct Superquadric // superelipsoida, e1 - wykladnik w kierunku fi, e2 - w kierunku theta
+{
+	glm::vec3 radii;
+	float e1;
+	float e2;
+
+	float fiMin() const { return -glm::half_pi<float>(); }
+	float fiMax() const { return glm::half_pi<float>(); }
+	bool hasPoles() const { return true; }
+
+	static float signedPow(float x, float e) { return std::copysign(std::pow(std::fabs(x), e), x); }
+
+	glm::vec3 operator()(const Angle& theta, const Angle& fi) const
+	{
+		float cf = signedPow(fi.cosine, e1);
+		return radii * glm::vec3(cf * signedPow(theta.cosine, e2), cf * signedPow(theta.sine, e2), signedPow(fi.sine, e1));
+	}
+};
+
+/*------------------------------------------------------------------------------------------
+** liczba wierzcholkow / indeksow siatki o vMax + 1 wierszach i uMax kolumnach
+** poles - czy siatka jest domykana w biegunie (Surface::hasPoles())
+**------------------------------------------------------------------------------------------*/
+inline int surfaceVertexCount(int vMax, int uMax)
+{
+	return (vMax + 1) * uMax;
+}
+
+inline int surfaceIndexCount(int vMax, int uMax, bool poles)
+{
+	return poles ? 3 * uMax + 6 * (vMax * uMax - 2) : 6 * vMax * uMax;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja generujaca wierzcholki (x, y, z, 1) dowolnej powierzchni parametrycznej
+** surface - powierzchnia (funktor), wywolanie jest rozwijane w miejscu przez kompilator
+** vMax - liczba podzialow w kierunku fi (siatka ma vMax + 1 wierszy)
+** uMax - liczba podzialow w kierunku theta
+** vertices - miejsce docelowe na 4 * surfaceVertexCount(vMax, uMax) liczb, np. zmapowana
+**            pamiec bufora VBO
+** sinusy i cosinusy liczone sa raz na kolumne (theta) i raz na wiersz (fi), a wiersze
+** wypelniane sa rownolegle
+**------------------------------------------------------------------------------------------*/
+template <typename Surface>
+void generateSurfaceVertices(const Surface& surface, int vMax, int uMax, float* vertices)
+{
+	const float fiMin = surface.fiMin();
+	const float fiStep = (surface.fiMax() - fiMin) / vMax;
+	const float thetaStep = THETA_MAX / uMax;
+
+	std::vector<Angle> thetas(uMax);
+	for (int j = 0; j < uMax; j++)
+		thetas[j] = makeAngle(j * thetaStep);
+
+	#pragma omp parallel for
+	for (int i = 0; i < vMax + 1; i++)
+	{
+		const Angle fi = makeAngle(fiMin + i * fiStep);
+		float* row = vertices + 4 * i * uMax;
+
+		for (int j = 0; j < uMax; j++)
+		{
+			glm::vec3 p = surface(thetas[j], fi);
+
+			row[4 * j + 0] = p.x;
+			row[4 * j + 1] = p.y;
+			row[4 * j + 2] = p.z;
+			row[4 * j + 3] = 1.0f;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja generujaca indeksy trojkatow siatki bez biegunow (torus, walec, stozek) - kazdy
+** z vMax pasow miedzy sasiednimi wierszami sklada sie z uMax quadow, a ostatni quad pasa
+** zamyka go z pierwsza kolumna
+** indices - miejsce docelowe na surfaceIndexCount(vMax, uMax, false) indeksow
+**------------------------------------------------------------------------------------------*/
+inline void generateGridIndices(int vMax, int uMax, unsigned int* indices)
+{
+	#pragma omp parallel for
+	for (int i = 0; i < vMax; i++)
+	{
+		unsigned int* quad = indices + 6 * i * uMax;
+
+		for (int j = 0; j < uMax; j++)
+		{
+			const unsigned int a = i * uMax + j; // dolny wiersz
+			const unsigned int b = i * uMax + (j + 1) % uMax;
+			const unsigned int c = a + uMax; // gorny wiersz
+			const unsigned int d = b + uMax;
+
+			quad[0] = b; //	1/2 quada
+			quad[1] = c;
+			quad[2] = d;
+
+			quad[3] = b; //	2/2 quada
+			quad[4] = c;
+			quad[5] = a;
+
+			quad += 6;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja generujaca indeksy trojkatow siatki o vMax + 1 wierszach i uMax kolumnach
+** poles - powierzchnia z biegunem (Surface::hasPoles()): domkniecie dolnego bieguna,
+**         a nastepnie ciagly pas quadow wokol powierzchni; w przeciwnym razie siatka
+**         okresowa z generateGridIndices
+** indices - miejsce docelowe na surfaceIndexCount(vMax, uMax, poles) indeksow
+**------------------------------------------------------------------------------------------*/
+inline void generateSurfaceIndices(int vMax, int uMax, bool poles, unsigned int* indices)
+{
+	if (!poles)
+	{
+		generateGridIndices(vMax, uMax, indices);
+		return;
+	}
+
+	unsigned int* out = indices;
+
+	for (int j = 1; j <= uMax; j++) // 0, j, j + 1 - domkniecie
+	{
+		*out++ = 0;
+		*out++ = j;
+		*out++ = j + 1;
+	}
+
+	const int quads = vMax * uMax - 2;
+
+	#pragma omp parallel for
+	for (int n = 0; n < quads; n++)
+	{
+		const unsigned int i = n + 2;
+		const unsigned int j = i + uMax - 1;
+		unsigned int* quad = out + 6 * n;
+
+		quad[0] = i; //	1/2 quada
+		quad[1] = j;
+		quad[2] = j + 1;
+
+		quad[3] = i; //	2/2 quada
+		quad[4] = j;
+		quad[5] = i - 1;
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza unikalne krawedzie siatki trojkatow (pary indeksow dla GL_LINES)
+** indices - indeksy trojkatow
+** count - liczba indeksow
+** edges - wektor na indeksy krawedzi; kolejnosc krawedzi odpowiada kolejnosci ich
+**         pierwszego wystapienia, wiec wynik jest deterministyczny
+** duplikaty odrzucane sa przy pomocy tablicy mieszajacej z adresowaniem otwartym,
+** krawedzie zdegenerowane (a == b) sa pomijane
+**------------------------------------------------------------------------------------------*/
+inline void extractEdges(const unsigned int* indices, int count, std::vector<unsigned int>& edges)
+{
+	size_t capacity = 1;
+	while (capacity <= static_cast<size_t>(count)) // krawedzi jest co najwyzej tyle co indeksow
+		capacity <<= 1;
+
+	const int shift = 64 - static_cast<int>(std::log2(static_cast<double>(capacity)));
+	std::vector<unsigned long long> table(capacity, 0); // 0 oznacza wolne miejsce (klucz nigdy nie jest zerem, bo b > a)
+
+	edges.clear();
+	edges.reserve(count);
+
+	for (int t = 0; t + 2 < count; t += 3)
+	{
+		for (int e = 0; e < 3; e++)
+		{
+			unsigned int a = indices[t + e];
+			unsigned int b = indices[t + (e + 1) % 3];
+
+			if (a == b)
+				continue;
+			if (a > b)
+				std::swap(a, b);
+
+			const unsigned long long key = (static_cast<unsigned long long>(a) << 32) | b;
+			size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift);
+
+			while (table[slot] != 0 && table[slot] != key)
+				slot = (slot + 1) & (capacity - 1);
+
+			if (table[slot] == 0)
+			{
+				table[slot] = key;
+				edges.push_back(a);
+				edges.push_back(b);
+			}
+		}
+	}
+}
+
+#endif /* __MESH_H__ */
@@ -0,0 +1,97 @@
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <iostream>
+
+#include "perf.h"
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca szczytowe zuzycie pamieci fizycznej procesu (peak RSS) w bajtach
+**------------------------------------------------------------------------------------------*/
+size_t peakMemoryUsage()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+		return static_cast<size_t>(usage.ru_maxrss) * 1024; // ru_maxrss w kilobajtach
+
+	return 0;
+#endif
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyswietla szczytowe zuzycie pamieci
+** label - opis wyswietlany przed wartoscia
+**------------------------------------------------------------------------------------------*/
+void printMemoryUsage(const char* label)
+{
+	std::cout << label << ": peak RSS = " << peakMemoryUsage() / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzy obiekty zapytan
+**------------------------------------------------------------------------------------------*/
+void GpuTimer::init()
+{
+	glGenQueries(QUERY_COUNT, queries);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa obiekty zapytan
+**------------------------------------------------------------------------------------------*/
+void GpuTimer::destroy()
+{
+	glDeleteQueries(QUERY_COUNT, queries);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rozpoczyna pomiar; jesli biezace zapytanie bylo juz uzyte, jego wynik jest
+** najpierw dodawany do sumy
+**------------------------------------------------------------------------------------------*/
+void GpuTimer::begin()
+{
+	if (pending[current])
+	{
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(queries[current], GL_QUERY_RESULT, &elapsed);
+
+		totalMs += elapsed / 1.0e6;
+		samples++;
+		pending[current] = false;
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja konczy pomiar
+**------------------------------------------------------------------------------------------*/
+void GpuTimer::end()
+{
+	glEndQuery(GL_TIME_ELAPSED);
+
+	pending[current] = true;
+	current = (current + 1) % QUERY_COUNT;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zeruje zebrane wyniki (zapytania w toku sa porzucane)
+**------------------------------------------------------------------------------------------*/
+void GpuTimer::reset()
+{
+	for (int i = 0; i < QUERY_COUNT; i++)
+		pending[i] = false;
+
+	totalMs = 0.0;
+	samples = 0;
+}
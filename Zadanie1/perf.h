@@ -0,0 +1,46 @@
+#ifndef __PERF_H__
+#define __PERF_H__
+
+#include <GL/glew.h>
+#include <chrono>
+
+size_t peakMemoryUsage();
+void printMemoryUsage(const char* label);
+
+/*------------------------------------------------------------------------------------------
+** prosty stoper do pomiaru czasu po stronie CPU
+**------------------------------------------------------------------------------------------*/
+struct Stopwatch
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	double elapsedMs() const
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+};
+
+/*------------------------------------------------------------------------------------------
+** pomiar czasu wykonania polecen na GPU (zapytania GL_TIME_ELAPSED)
+** wyniki odczytywane sa z opoznieniem kilku klatek, aby nie wstrzymywac potoku
+**------------------------------------------------------------------------------------------*/
+struct GpuTimer
+{
+	static const int QUERY_COUNT = 4;
+
+	GLuint queries[QUERY_COUNT] = {};
+	bool pending[QUERY_COUNT] = {};
+	int current = 0;
+
+	double totalMs = 0.0; // suma zmierzonych czasow
+	int samples = 0; // liczba zmierzonych klatek
+
+	void init();
+	void destroy();
+	void begin();
+	void end();
+	double averageMs() const { return samples > 0 ? totalMs / samples : 0.0; }
+	void reset();
+};
+
+#endif /* __PERF_H__ */
@@ -0,0 +1,89 @@
+#ifndef __RENDERQUEUE_H__
+#define __RENDERQUEUE_H__
+
+#include <GL/glew.h>
+
+#include <vector>
+
+#include "statecache.h"
+
+// typy zmiennych jednorodnych ustawianych przez kolejke rysowania
+enum UniformType { UNIFORM_INT, UNIFORM_VEC4, UNIFORM_MAT3X2 };
+
+// rodzaje wywolan rysowania
+enum DrawType { DRAW_ARRAYS, DRAW_ELEMENTS, DRAW_ARRAYS_INDIRECT, DRAW_ELEMENTS_INDIRECT };
+
+/*------------------------------------------------------------------------------------------
+** wartosc zmiennej jednorodnej - wskazywane dane musza byc dostepne do wykonania kolejki
+**------------------------------------------------------------------------------------------*/
+struct Uniform
+{
+	GLint location = -1; // -1 - brak zmiennej
+	UniformType type = UNIFORM_VEC4;
+	GLsizei count = 1; // liczba elementow tablicy (UNIFORM_MAT3X2)
+	const void* value = nullptr;
+};
+
+/*------------------------------------------------------------------------------------------
+** material - zmienne jednorodne wspolne dla wielu rysowan (np. kolor); rysowania sa
+** grupowane wedlug adresu materialu
+**------------------------------------------------------------------------------------------*/
+struct Material
+{
+	std::vector<Uniform> uniforms;
+};
+
+/*------------------------------------------------------------------------------------------
+** jedno rysowanie - stan, dane obiektu i parametry wywolania glDraw*
+**------------------------------------------------------------------------------------------*/
+struct RenderCommand
+{
+	GLuint program = 0;
+	GLuint vertexArray = 0;
+	const Material* material = nullptr;
+
+	// dane obiektu - zmienna jednorodna lub fragment bufora (UBO / SSBO)
+	Uniform objectUniform;
+	BufferRange objectBuffer;
+
+	DrawType type = DRAW_ARRAYS; // indeksy DRAW_ELEMENTS* sa typu GL_UNSIGNED_INT
+	GLenum mode = GL_TRIANGLES;
+	GLintptr first = 0; // pierwszy wierzcholek (DRAW_ARRAYS) albo przesuniecie w bajtach w buforze indeksow lub polecen
+	GLsizei count = 0; // liczba wierzcholkow / indeksow albo polecen rysowania posredniego
+	GLsizei instances = 1;
+	GLuint indirectBuffer = 0; // bufor polecen dla DRAW_*_INDIRECT
+};
+
+/*------------------------------------------------------------------------------------------
+** kolejka rysowania - kazde rysowanie dostaje 64-bitowy klucz
+**   przebieg (4 bity) | program (8) | VAO (12) | material (12) | glebokosc (28)
+** a przed wykonaniem kolejka sortowana jest pozycyjnie (radix sort), wiec rysowania
+** o tym samym stanie wykonywane sa po sobie i StateCache pomija powtorzone zmiany stanu
+** program, VAO i material zamieniane sa w kluczu na numery kolejnosci pierwszego uzycia
+** (od ostatniego clear);
+** sortowanie jest stabilne - rysowania o rownych kluczach zachowuja kolejnosc dodania
+**------------------------------------------------------------------------------------------*/
+struct RenderQueue
+{
+	struct SortItem
+	{
+		GLuint64 key;
+		GLuint command;
+	};
+
+	std::vector<RenderCommand> commands;
+	std::vector<SortItem> items; // klucze i numery rysowan, po sort() w kolejnosci wykonania
+	std::vector<SortItem> scratch; // bufor pomocniczy sortowania
+
+	std::vector<GLuint> programs; // numery programow, VAO i materialow w kluczu
+	std::vector<GLuint> vertexArrays;
+	std::vector<const Material*> materials;
+
+	void clear();
+	void submit(const RenderCommand& command, int pass = 0, float depth = 0.0f);
+	void sort();
+	void execute(StateCache& state) const;
+	void flush(StateCache& state);
+};
+
+#endif /* __RENDERQUEUE_H__ */
@@ -0,0 +1,173 @@
+#include <iostream>
+
+#include "ringbuffer.h"
+#include "perf.h"
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzy bufor o REGION_COUNT regionach
+** bufferTarget - cel, do ktorego dowiazywany jest bufor (np. GL_UNIFORM_BUFFER)
+** bufferRegionSize - rozmiar jednego regionu (danych jednej klatki) w bajtach
+** bufferAlignment - wyrownanie poczatku alokacji (np. GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+** allowPersistent - czy uzyc trwalego mapowania, jesli dostepne jest ARB_buffer_storage
+**------------------------------------------------------------------------------------------*/
+void RingBuffer::init(GLenum bufferTarget, GLsizeiptr bufferRegionSize, GLsizeiptr bufferAlignment, bool allowPersistent)
+{
+	target = bufferTarget;
+	alignment = bufferAlignment;
+	regionSize = (bufferRegionSize + alignment - 1) / alignment * alignment;
+	persistent = allowPersistent && (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage);
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(target, buffer);
+
+	if (persistent)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glBufferStorage(target, REGION_COUNT * regionSize, nullptr, flags);
+		mapped = static_cast<unsigned char*>(glMapBufferRange(target, 0, REGION_COUNT * regionSize, flags));
+
+		if (mapped == nullptr)
+		{
+			std::cerr << "Nie mozna zmapowac bufora strumieniowego (" << REGION_COUNT * regionSize << " B)\n";
+			exit(4);
+		}
+	}
+	else
+	{
+		glBufferData(target, REGION_COUNT * regionSize, nullptr, GL_STREAM_DRAW);
+	}
+
+	std::cout << "Bufor strumieniowy: " << REGION_COUNT << " x " << regionSize << " B, "
+		<< (persistent ? "trwale mapowanie (ARB_buffer_storage)" : "glMapBufferRange co klatke") << std::endl;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa bufor i ploty
+**------------------------------------------------------------------------------------------*/
+void RingBuffer::destroy()
+{
+	for (GLsync& fence : fences)
+	{
+		if (fence != 0)
+			glDeleteSync(fence);
+		fence = 0;
+	}
+
+	if (persistent && buffer != 0)
+	{
+		glBindBuffer(target, buffer);
+		glUnmapBuffer(target);
+	}
+
+	glDeleteBuffers(1, &buffer);
+	buffer = 0;
+	mapped = nullptr;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rozpoczyna klatke - przechodzi do kolejnego regionu i, jesli GPU wciaz czyta
+** z niego dane sprzed REGION_COUNT klatek, czeka na jego zwolnienie (liczone w stalls)
+**------------------------------------------------------------------------------------------*/
+void RingBuffer::beginFrame()
+{
+	region = (region + 1) % REGION_COUNT;
+	used = 0;
+
+	GLsync& fence = fences[region];
+	if (fence == 0)
+		return;
+
+	if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+	{
+		Stopwatch stopwatch;
+
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+			;
+
+		stalls++;
+		stallMs += stopwatch.elapsedMs();
+	}
+
+	glDeleteSync(fence);
+	fence = 0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja przydziela miejsce w regionie biezacej klatki
+** size - rozmiar danych w bajtach
+** offset - przesuniecie przydzielonych danych od poczatku bufora (dla glBindBufferRange)
+** funkcja zwraca wskaznik, pod ktory nalezy zapisac dane; po zapisie trzeba wywolac unmap
+**------------------------------------------------------------------------------------------*/
+void* RingBuffer::map(GLsizeiptr size, GLintptr& offset)
+{
+	const GLsizeiptr start = (used + alignment - 1) / alignment * alignment;
+	if (start + size > regionSize)
+	{
+		std::cerr << "Przepelnienie bufora strumieniowego (" << start + size << " z " << regionSize << " B)\n";
+		exit(4);
+	}
+
+	used = start + size;
+	offset = region * regionSize + start;
+
+	if (persistent)
+		return mapped + offset;
+
+	// region nie jest uzywany przez GPU (plot), wiec synchronizacja sterownika jest zbedna
+	glBindBuffer(target, buffer);
+	void* data = glMapBufferRange(target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (data == nullptr)
+	{
+		std::cerr << "Nie mozna zmapowac bufora strumieniowego (" << size << " B)\n";
+		exit(4);
+	}
+
+	return data;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja konczy zapis danych przydzielonych przez map (przy trwalym, spojnym mapowaniu
+** dane sa widoczne dla GPU bez dodatkowych wywolan)
+**------------------------------------------------------------------------------------------*/
+void RingBuffer::unmap()
+{
+	if (persistent)
+		return;
+
+	glBindBuffer(target, buffer);
+	glUnmapBuffer(target); // utrata zawartosci dotyczy tylko tej klatki, dane zostana zapisane w nastepnej
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja konczy klatke - wstawia plot za poleceniami rysowania, ktore czytaja region;
+** jesli klatka nie zapisala nowych danych (bez beginFrame), plot regionu jest zastepowany
+** nowszym, bo GPU wciaz czyta z niego dane
+**------------------------------------------------------------------------------------------*/
+void RingBuffer::endFrame()
+{
+	if (fences[region] != 0)
+		glDeleteSync(fences[region]);
+
+	fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	frames++;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zeruje liczniki oczekiwan
+**------------------------------------------------------------------------------------------*/
+void RingBuffer::resetStats()
+{
+	frames = 0;
+	stalls = 0;
+	stallMs = 0.0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyswietla liczniki oczekiwan CPU na GPU
+** label - opis wyswietlany przed wynikami
+**------------------------------------------------------------------------------------------*/
+void RingBuffer::printStats(const char* label) const
+{
+	std::cout << label << ": " << stalls << " oczekiwan na GPU w " << frames << " klatkach, " << stallMs << " ms" << std::endl;
+}
@@ -1,10 +1,22 @@
 #ifndef __SHADERS_H__
 #define __SHADERS_H__
 
+#include <string>
+#include <vector>
+
+// plik z kodem zrodlowym shadera wraz z jego typem (GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, ...)
+struct ShaderFile
+{
+	std::string filename;
+	GLenum type;
+};
+
 GLchar* loadShaderSource(std::string filename);
 bool createShader(std::string filename, GLenum shaderType, GLuint& shader);
 void printShaderInfoLog(GLuint shader);
 void printProgramInfoLog(GLuint program);
+bool setupProgram(const std::vector<ShaderFile>& files, GLuint& shaderProgram);
 bool setupShaders(std::string vertexShaderFilename, std::string fragmentShaderFilename, GLuint& shaderProgram);
+bool setupShaders(std::string vertexShaderFilename, std::string geometryShaderFilename, std::string fragmentShaderFilename, GLuint& shaderProgram);
 
 #endif /* __SHADERS_H__ */
\ No newline at end of file
@@ -1,11 +1,16 @@
 #version 330
+
+// dane obiektu - fragment bufora UBO wybierany przez glBindBufferRange
+layout(std140) uniform ObjectBlock
+{
+	mat4 mvpMatrix; // iloczyn macierzy projekcji i model-widok
+	vec4 color;
+	vec4 fillColor;
+};
  
-uniform mat4 modelViewMatrix; // macierz model-widok
-uniform mat4 projectionMatrix; // macierz projekcji
- 
-in vec4 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
+layout(location = 0) in vec4 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
  
 void main()
 {
-    gl_Position = projectionMatrix * modelViewMatrix * vPosition;
+    gl_Position = mvpMatrix * vPosition;
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+#version 330
+
+// dane wspolne dla calej klatki
+layout(std140) uniform FrameBlock
+{
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+	float lineWidth; // grubosc krawedzi w pikselach
+};
+
+// dane obiektu - fragment bufora UBO wybierany przez glBindBufferRange
+layout(std140) uniform ObjectBlock
+{
+	mat4 mvpMatrix;
+	vec4 color; // kolor krawedzi
+	vec4 fillColor; // kolor wypelnienia
+};
+
+noperspective in vec3 barycentric;
+
+out vec4 fColor;
+
+void main()
+{
+    // odleglosc od najblizszej krawedzi wyrazona w pikselach (fwidth - zmiana na piksel)
+    vec3 distance = barycentric / fwidth(barycentric);
+    float edge = min(min(distance.x, distance.y), distance.z);
+
+    // wygladzenie krawedzi na szerokosci jednego piksela
+    float coverage = 1.0 - smoothstep(0.5 * lineWidth - 0.5, 0.5 * lineWidth + 0.5, edge);
+
+    fColor = mix(fillColor, color, coverage);
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef __STATECACHE_H__
+#define __STATECACHE_H__
+
+#include <GL/glew.h>
+
+#include <unordered_map>
+#include <vector>
+
+// rodzaje wywolan zmieniajacych stan, zliczane przez StateCache
+enum StateCall { STATE_PROGRAM, STATE_VERTEX_ARRAY, STATE_BUFFER, STATE_POLYGON_MODE, STATE_LINE_WIDTH, STATE_UNIFORM, STATE_CALLS };
+
+// fragment bufora dowiazywany do indeksowanego punktu wiazania
+struct BufferRange
+{
+	GLenum target = GL_UNIFORM_BUFFER;
+	GLuint index = 0;
+	GLuint buffer = 0; // 0 - brak bufora
+	GLintptr offset = 0;
+	GLsizeiptr size = 0; // 0 - caly bufor (glBindBufferBase)
+};
+
+/*------------------------------------------------------------------------------------------
+** pamiec podreczna stanu OpenGL - pamieta dowiazany program, VAO, bufory, tryb rysowania
+** wielokatow, grubosc linii i wartosci zmiennych jednorodnych, a wywolania, ktore nic nie
+** zmieniaja, pomija
+** stan zmieniony z pominieciem StateCache (np. przy tworzeniu buforow) trzeba zglosic
+** wywolaniem invalidate()
+**------------------------------------------------------------------------------------------*/
+struct StateCache
+{
+	static const GLuint UNKNOWN = ~0u; // stan nieznany - najblizsze wywolanie nie zostanie pominiete
+
+	// dowiazanie do indeksowanego punktu (glBindBufferBase / glBindBufferRange)
+	struct IndexedBinding
+	{
+		GLuint buffer;
+		GLintptr offset;
+		GLsizeiptr size; // 0 - caly bufor (glBindBufferBase)
+	};
+
+	GLuint currentProgram = UNKNOWN;
+	GLuint currentVertexArray = UNKNOWN;
+	GLenum currentPolygonMode = UNKNOWN;
+	GLfloat currentLineWidth = -1.0f;
+	std::unordered_map<GLenum, GLuint> buffers; // cel -> bufor
+	std::unordered_map<GLuint64, IndexedBinding> indexedBuffers; // (cel, indeks) -> dowiazanie
+	std::unordered_map<GLuint64, std::vector<unsigned char>> uniforms; // (program, lokalizacja) -> wartosc
+
+	long long issued[STATE_CALLS] = {}; // liczba wywolan przekazanych do OpenGL
+	long long filtered[STATE_CALLS] = {}; // liczba pominietych wywolan
+	long long frames = 0;
+
+	void useProgram(GLuint program);
+	void bindVertexArray(GLuint vertexArray);
+	void bindBuffer(GLenum target, GLuint buffer);
+	void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+	void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+	void bindBufferRange(const BufferRange& range) { bindBufferRange(range.target, range.index, range.buffer, range.offset, range.size); }
+	void polygonMode(GLenum mode);
+	void lineWidth(GLfloat width);
+	void uniform1i(GLint location, GLint value);
+	void uniform4fv(GLint location, const GLfloat* value);
+	void uniformMatrix3x2fv(GLint location, GLsizei matrices, const GLfloat* value);
+
+	void invalidate();
+	void endFrame() { frames++; }
+	void resetStats();
+	void printStats(const char* label) const;
+	bool count(StateCall call, bool changed);
+	bool uniformChanged(GLint location, const void* value, size_t size);
+};
+
+#endif /* __STATECACHE_H__ */
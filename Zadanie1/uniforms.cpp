@@ -0,0 +1,103 @@
+#include <cstring>
+
+#include "uniforms.h"
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzy bufory UBO i dowiazuje bufor klatki do punktu FRAME_BLOCK_BINDING
+** capacity - maksymalna liczba obiektow zapisywanych w jednej klatce
+** allowPersistent - czy dane obiektow zapisywac do trwale zmapowanego bufora
+**------------------------------------------------------------------------------------------*/
+void UniformBlocks::init(int capacity, bool allowPersistent)
+{
+	GLint alignment;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+	objectStride = (sizeof(ObjectBlock) + alignment - 1) / alignment * alignment;
+	objectCapacity = capacity;
+
+	glGenBuffers(1, &frameBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameBlock), nullptr, GL_DYNAMIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, frameBuffer);
+
+	objectRing.init(GL_UNIFORM_BUFFER, objectCapacity * objectStride, alignment, allowPersistent);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa bufory UBO
+**------------------------------------------------------------------------------------------*/
+void UniformBlocks::destroy()
+{
+	glDeleteBuffers(1, &frameBuffer);
+	objectRing.destroy();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja przypisuje blokom FrameBlock i ObjectBlock programu ich punkty wiazania
+** (bloki nieuzywane przez program sa pomijane)
+** program - identyfikator programu cieniowania
+**------------------------------------------------------------------------------------------*/
+void UniformBlocks::bindProgram(GLuint program) const
+{
+	GLuint frameIndex = glGetUniformBlockIndex(program, "FrameBlock");
+	if (frameIndex != GL_INVALID_INDEX)
+		glUniformBlockBinding(program, frameIndex, FRAME_BLOCK_BINDING);
+
+	GLuint objectIndex = glGetUniformBlockIndex(program, "ObjectBlock");
+	if (objectIndex != GL_INVALID_INDEX)
+		glUniformBlockBinding(program, objectIndex, OBJECT_BLOCK_BINDING);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zapisuje dane klatki - wywolywana tylko gdy zmieni sie ktoras z wartosci
+** frame - dane klatki
+**------------------------------------------------------------------------------------------*/
+void UniformBlocks::updateFrame(const FrameBlock& frame) const
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameBlock), &frame);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rozpoczyna klatke i zapisuje dane wszystkich jej obiektow do kolejnego regionu
+** bufora strumieniowego; kolejne obiekty leza co objectStride bajtow
+** objects - dane obiektow
+** count - liczba obiektow (co najwyzej objectCapacity)
+**------------------------------------------------------------------------------------------*/
+void UniformBlocks::updateObjects(const ObjectBlock* objects, int count)
+{
+	objectRing.beginFrame();
+
+	unsigned char* data = static_cast<unsigned char*>(objectRing.map(count * objectStride, objectOffset));
+
+	for (int i = 0; i < count; i++)
+		std::memcpy(data + i * objectStride, &objects[i], sizeof(ObjectBlock));
+
+	objectRing.unmap();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca fragment bufora z danymi obiektu do dowiazania przed jego rysowaniem
+** (glBindBufferRange)
+** index - indeks obiektu w tablicy przekazanej do updateObjects
+**------------------------------------------------------------------------------------------*/
+BufferRange UniformBlocks::objectRange(int index) const
+{
+	BufferRange range;
+
+	range.target = GL_UNIFORM_BUFFER;
+	range.index = OBJECT_BLOCK_BINDING;
+	range.buffer = objectRing.buffer;
+	range.offset = objectOffset + index * objectStride;
+	range.size = sizeof(ObjectBlock);
+
+	return range;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja konczy klatke - wywolywana po ostatnim rysowaniu korzystajacym z danych obiektow
+**------------------------------------------------------------------------------------------*/
+void UniformBlocks::endFrame()
+{
+	objectRing.endFrame();
+}
@@ -0,0 +1,57 @@
+#ifndef __UNIFORMS_H__
+#define __UNIFORMS_H__
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ringbuffer.h"
+#include "statecache.h"
+
+const GLuint FRAME_BLOCK_BINDING = 0; // punkt wiazania bloku FrameBlock
+const GLuint OBJECT_BLOCK_BINDING = 1; // punkt wiazania bloku ObjectBlock
+
+/*------------------------------------------------------------------------------------------
+** dane wspolne dla calej klatki - odpowiada blokowi FrameBlock (std140) w shaderach
+**------------------------------------------------------------------------------------------*/
+struct FrameBlock
+{
+	glm::mat4 projectionMatrix;
+	glm::mat4 viewMatrix;
+	float lineWidth; // grubosc krawedzi w pikselach
+	float padding[3];
+};
+
+/*------------------------------------------------------------------------------------------
+** dane jednego obiektu - odpowiada blokowi ObjectBlock (std140) w shaderach
+**------------------------------------------------------------------------------------------*/
+struct ObjectBlock
+{
+	glm::mat4 mvpMatrix; // iloczyn macierzy projekcji i model-widok
+	glm::vec4 color;
+	glm::vec4 fillColor; // kolor wypelnienia pod siatka (WIREFRAME_BARYCENTRIC)
+};
+
+/*------------------------------------------------------------------------------------------
+** bufory UBO z danymi klatki i obiektow - dane wszystkich obiektow zapisywane sa raz na
+** klatke do kolejnego regionu bufora strumieniowego, a przed rysowaniem obiektu wybierany
+** jest jego fragment (objectRange), wiec rysowanie nie wymaga zadnych wywolan
+** glUniform*
+**------------------------------------------------------------------------------------------*/
+struct UniformBlocks
+{
+	GLuint frameBuffer = 0;
+	RingBuffer objectRing; // dane obiektow kolejnych klatek
+	GLintptr objectOffset = 0; // poczatek danych obiektow biezacej klatki w objectRing
+	GLsizeiptr objectStride = 0; // rozmiar ObjectBlock wyrownany do GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+	int objectCapacity = 0;
+
+	void init(int capacity, bool allowPersistent);
+	void destroy();
+	void bindProgram(GLuint program) const;
+	void updateFrame(const FrameBlock& frame) const;
+	void updateObjects(const ObjectBlock* objects, int count);
+	BufferRange objectRange(int index) const;
+	void endFrame();
+};
+
+#endif /* __UNIFORMS_H__ */
@@ -0,0 +1,63 @@
+#ifndef __AFFINE2D_H__
+#define __AFFINE2D_H__
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+
+/*------------------------------------------------------------------------------------------
+** przeksztalcenie afiniczne 2D jako glm::mat3x2 (3 kolumny, 2 wiersze) - kolumny 0 i 1 to
+** czesc liniowa, kolumna 2 to przesuniecie; odpowiada typowi mat3x2 w GLSL, wiec moze byc
+** wysylane bez konwersji (glUniformMatrix3x2fv lub trzy atrybuty vec2)
+** funkcje skladaja przeksztalcenia tak jak glm::translate / glm::rotate / glm::scale, tzn.
+** nowe przeksztalcenie jest wykonywane przed dotychczasowym (m * T)
+**------------------------------------------------------------------------------------------*/
+typedef glm::mat3x2 Affine2D;
+
+inline Affine2D affineIdentity()
+{
+	return Affine2D(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+}
+
+inline Affine2D affineTranslate(const Affine2D& m, const glm::vec2& t)
+{
+	Affine2D result = m;
+	result[2] += m[0] * t.x + m[1] * t.y;
+	return result;
+}
+
+inline Affine2D affineRotate(const Affine2D& m, float angle) // kat w radianach
+{
+	const float c = std::cos(angle);
+	const float s = std::sin(angle);
+
+	Affine2D result = m;
+	result[0] = m[0] * c + m[1] * s;
+	result[1] = m[1] * c - m[0] * s;
+	return result;
+}
+
+inline Affine2D affineScale(const Affine2D& m, const glm::vec2& s)
+{
+	Affine2D result = m;
+	result[0] *= s.x;
+	result[1] *= s.y;
+	return result;
+}
+
+inline glm::vec2 affineTransform(const Affine2D& m, const glm::vec2& p)
+{
+	return m[0] * p.x + m[1] * p.y + m[2];
+}
+
+// macierz 4x4 rownowazna przeksztalceniu 2D (dla kodu operujacego na glm::mat4)
+inline glm::mat4 affineToMat4(const Affine2D& m)
+{
+	glm::mat4 result(1.0f);
+	result[0] = glm::vec4(m[0], 0.0f, 0.0f);
+	result[1] = glm::vec4(m[1], 0.0f, 0.0f);
+	result[3] = glm::vec4(m[2], 0.0f, 1.0f);
+	return result;
+}
+
+#endif /* __AFFINE2D_H__ */
@@ -0,0 +1,117 @@
+#include <iostream>
+
+#include "batch.h"
+#include "buffers.h"
+#include "perf.h"
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzy ksztalt batcha z tablicy wierzcholkow
+** vertices - wspolrzedne wierzcholkow
+** count - liczba wierzcholkow
+** components - liczba wspolrzednych wierzcholka (2 - x, y; 3 - x, y, z; 4 - x, y, z, w),
+**              brakujace uzupelniane sa jak w OpenGL (z = 0, w = 1)
+** mode - GL_TRIANGLES lub GL_TRIANGLE_STRIP (pas zamieniany jest na liste trojkatow
+**        z zachowaniem kierunku obiegu)
+**------------------------------------------------------------------------------------------*/
+BatchShape makeBatchShape(const float* vertices, int count, int components, GLenum mode)
+{
+	BatchShape shape;
+
+	auto vertex = [vertices, components](int i)
+	{
+		glm::vec4 v(0.0f, 0.0f, 0.0f, 1.0f);
+		for (int c = 0; c < components; c++)
+			v[c] = vertices[components * i + c];
+		return v;
+	};
+
+	if (mode == GL_TRIANGLE_STRIP)
+	{
+		for (int i = 0; i + 2 < count; i++)
+		{
+			shape.vertices.push_back(vertex((i % 2 == 0) ? i : i + 1));
+			shape.vertices.push_back(vertex((i % 2 == 0) ? i + 1 : i));
+			shape.vertices.push_back(vertex(i + 2));
+		}
+	}
+	else
+	{
+		for (int i = 0; i < count; i++)
+			shape.vertices.push_back(vertex(i));
+	}
+
+	return shape;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja przeksztalca wszystkie obiekty do jednego bufora wierzcholkow i inicjuje VAO
+** shapes - ksztalty, do ktorych odwoluja sie obiekty
+** objects - obiekty statyczne
+** positionLoc - lokalizacja atrybutu pozycji wierzcholka
+** colorLoc - lokalizacja atrybutu koloru wierzcholka
+** poczatek kazdego obiektu w buforze wyznaczany jest sumami prefiksowymi, a obiekty
+** przeksztalcane sa rownolegle bezposrednio w zmapowanej pamieci bufora
+**------------------------------------------------------------------------------------------*/
+void StaticBatch::build(const std::vector<BatchShape>& shapes, const std::vector<BatchObject>& objects, GLuint positionLoc, GLuint colorLoc)
+{
+	Stopwatch stopwatch;
+
+	const int objectCount = static_cast<int>(objects.size());
+
+	std::vector<GLsizei> first(objectCount + 1);
+	first[0] = 0;
+	for (int i = 0; i < objectCount; i++)
+		first[i + 1] = first[i] + static_cast<GLsizei>(shapes[objects[i].shape].vertices.size());
+
+	vertexCount = first[objectCount];
+
+	if (vao == 0)
+	{
+		glGenVertexArrays(1, &vao);
+		glGenBuffers(1, &buffer);
+	}
+
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+	fillBuffer<BatchVertex>(GL_ARRAY_BUFFER, vertexCount * sizeof(BatchVertex), [&](BatchVertex* data)
+	{
+		#pragma omp parallel for
+		for (int i = 0; i < objectCount; i++)
+		{
+			const BatchObject& object = objects[i];
+			const BatchShape& shape = shapes[object.shape];
+			BatchVertex* out = data + first[i];
+
+			for (const glm::vec4& v : shape.vertices)
+			{
+				out->position = glm::vec3(object.matrix * v);
+				std::copy(object.color, object.color + 4, out->color);
+				out++;
+			}
+		}
+	});
+
+	glEnableVertexAttribArray(positionLoc);
+	glVertexAttribPointer(positionLoc, 3, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), reinterpret_cast<void*>(offsetof(BatchVertex, position)));
+
+	glEnableVertexAttribArray(colorLoc);
+	glVertexAttribPointer(colorLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(BatchVertex), reinterpret_cast<void*>(offsetof(BatchVertex, color)));
+
+	glBindVertexArray(0);
+
+	std::cout << "Batch: " << objectCount << " obiektow, " << vertexCount << " wierzcholkow, " << stopwatch.elapsedMs() << " ms" << std::endl;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwalnia VAO i bufor batcha
+**------------------------------------------------------------------------------------------*/
+void StaticBatch::destroy()
+{
+	glDeleteBuffers(1, &buffer);
+	glDeleteVertexArrays(1, &vao);
+
+	vao = 0;
+	buffer = 0;
+	vertexCount = 0;
+}
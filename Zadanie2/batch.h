@@ -0,0 +1,54 @@
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/*------------------------------------------------------------------------------------------
+** ksztalt wspoldzielony przez obiekty batcha - wierzcholki w lokalnym ukladzie
+** wspolrzednych jako lista trojkatow (GL_TRIANGLES)
+**------------------------------------------------------------------------------------------*/
+struct BatchShape
+{
+	std::vector<glm::vec4> vertices;
+};
+
+BatchShape makeBatchShape(const float* vertices, int count, int components, GLenum mode);
+
+/*------------------------------------------------------------------------------------------
+** obiekt statyczny - ksztalt, macierz przeksztalcenia i kolor
+**------------------------------------------------------------------------------------------*/
+struct BatchObject
+{
+	glm::mat4 matrix;
+	GLubyte color[4];
+	int shape; // indeks ksztaltu w tablicy przekazanej do StaticBatch::build
+};
+
+/*------------------------------------------------------------------------------------------
+** wierzcholek batcha - pozycja juz przeksztalcona macierza obiektu i kolor obiektu
+**------------------------------------------------------------------------------------------*/
+struct BatchVertex
+{
+	glm::vec3 position;
+	GLubyte color[4];
+};
+
+/*------------------------------------------------------------------------------------------
+** statyczny batch - dowolny zestaw niezmiennych obiektow przeksztalcony raz na CPU do
+** jednego bufora wierzcholkow (vao, vertexCount) i rysowany jednym wywolaniem glDrawArrays
+**------------------------------------------------------------------------------------------*/
+struct StaticBatch
+{
+	GLuint vao = 0;
+	GLuint buffer = 0;
+	GLsizei vertexCount = 0;
+
+	void build(const std::vector<BatchShape>& shapes, const std::vector<BatchObject>& objects, GLuint positionLoc, GLuint colorLoc);
+	void destroy();
+	bool empty() const { return vertexCount == 0; }
+};
+
+#endif /* __BATCH_H__ */
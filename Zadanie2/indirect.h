@@ -0,0 +1,38 @@
+#ifndef __INDIRECT_H__
+#define __INDIRECT_H__
+
+#include <GL/glew.h>
+
+const GLuint DRAW_DATA_BINDING = 0; // punkt wiazania SSBO z danymi kolejnych rysowan (gl_DrawIDARB)
+
+/*------------------------------------------------------------------------------------------
+** polecenia rysowania posredniego - uklad zgodny z glMultiDrawArraysIndirect
+** i glMultiDrawElementsIndirect
+**------------------------------------------------------------------------------------------*/
+struct DrawArraysIndirectCommand
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint first;
+	GLuint baseInstance;
+};
+
+struct DrawElementsIndirectCommand
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+/*------------------------------------------------------------------------------------------
+** funkcja sprawdza, czy mozna rysowac wiele obiektow jednym wywolaniem glMultiDraw*Indirect
+** z danymi obiektow w SSBO indeksowanym przez gl_DrawIDARB (shadery w wersji 430)
+**------------------------------------------------------------------------------------------*/
+inline bool multiDrawSupported()
+{
+	return GLEW_VERSION_4_3 && GLEW_ARB_shader_draw_parameters;
+}
+
+#endif /* __INDIRECT_H__ */
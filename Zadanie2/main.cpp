@@ -8,34 +8,153 @@
 
 #include <iostream>
 #include <vector>
+#include <string>
+#include <cstdlib>
 
 #include "shaders.h"
+#include "buffers.h"
+#include "perf.h"
+#include "batch.h"
+#include "affine2d.h"
+#include "indirect.h"
+#include "statecache.h"
+#include "renderqueue.h"
 
 
 //const float ROTATION_OFFSET = 0.0f;
 const float ROTATION_OFFSET = 45.0f;
 
-const float SCALE = 0.2f, OFFSET = 0.8f, DIFF = 0.4f;
+const float SCALE = 0.2f, OFFSET = 0.8f, DIFF = 0.4f; // wartosci dla siatki GRID_SIZE x GRID_SIZE
+const float TRIANGLE_OFFSET = 0.15f; // odleglosc trojkatow od srodka kwadratu
 
 const float SQUARE_COLOR[] = { 0.0f, 1.0f, 0.0f, 1.0f };
 const float TRIANGLE_COLOR[] = { 1.0f, 0.0f, 0.0f, 1.0f };
 
+// wspolrzedne (x, y) wierzcholkow trojkata
+const float TRAINGLE_VERTICES[] =
+{
+	0.0f, 0.25f,
+	-0.25f, -0.25f,
+	0.25f, -0.25f
+};
+
+// wspolrzedne (x, y) wierzcholkow kwadratu (GL_TRIANGLE_STRIP)
+const float SQUARE_VERTICES[] =
+{
+	-0.5f, 0.5f,
+	-0.5f, -0.5f,
+	0.5f, 0.5f,
+	0.5f, -0.5f
+};
+
+const int GRID_SIZE = 5; // domyslna liczba kafelkow w wierszu i kolumnie
+const int GRID_LIMIT = 1000; // maksymalna liczba kafelkow w wierszu i kolumnie
+const int GRID_LIMIT_INDIVIDUAL = 250; // jw. dla trybu SUBMIT_INDIVIDUAL (5 rysowan na kafelek w kolejce rysowania)
+const int GRID_LIMIT_BUFFERLESS = 4096; // jw. dla trybu SUBMIT_INSTANCE_ID, ktory nie potrzebuje buforow instancji
+
+// sposoby wysylania kafelkow do rysowania, przelaczane klawiszem F2
+enum SubmitMode { SUBMIT_INDIVIDUAL, SUBMIT_INSTANCED, SUBMIT_INSTANCE_ID, SUBMIT_GEOMETRY, SUBMIT_STATIC_BATCH, SUBMIT_MULTI_DRAW, SUBMIT_MODES };
+
+const char* SUBMIT_MODE_NAMES[] = { "individual", "instanced", "gl_InstanceID", "geometry shader", "static batch", "multi-draw indirect" };
+
+const GLuint GRID_BLOCK_BINDING = 0; // punkt wiazania bloku GridBlock
+
+const GLint GRID_SQUARES = GL_FALSE, GRID_TRIANGLES = GL_TRUE; // wartosci zmiennej triangles w gridProgram
+
+// parametry rozmieszczenia kafelkow przeskalowane do aktualnego rozmiaru siatki
+struct GridLayout
+{
+	float offset;
+	float diff;
+	float scale;
+	float triangleOffset;
+};
+
+// blok zmiennych jednorodnych (std140), z ktorego grid.vert wyznacza polozenie kafelkow
+struct GridBlock
+{
+	glm::vec4 squareColor;
+	glm::vec4 triangleColor;
+	float offset;
+	float diff;
+	float scale;
+	float triangleOffset;
+	float rotationOffset; // w radianach
+	GLint gridSize;
+	float padding[2];
+};
+
+// dane jednej instancji kafelka (kwadratu lub trojkata)
+struct TileInstance
+{
+	Affine2D mvMatrix;
+	GLubyte color[4];
+};
+
+// dane jednego rysowania w trybie SUBMIT_MULTI_DRAW - uklad std430 struktury TileDraw z multidraw.vert
+struct TileDraw
+{
+	Affine2D mvMatrix;
+	GLubyte color[4];
+	float padding;
+};
 
 constexpr int WIDTH = 600; // szerokosc okna
 constexpr int HEIGHT = 600; // wysokosc okna
+constexpr int BENCHMARK_FRAMES = 50; // liczba klatek mierzonych dla kazdego wariantu w trybie --benchmark
 
 //******************************************************************************************
 GLuint shaderProgram; // identyfikator programu cieniowania
+GLuint instancedProgram; // identyfikator programu cieniowania dla rysowania instancyjnego
+GLuint gridProgram; // identyfikator programu cieniowania wyznaczajacego kafelki z gl_InstanceID
+
+GLuint gridTrianglesLoc; // lokalizacja zmiennej jednorodnej - czy rysowane sa trojkaty (gridProgram)
+
+GLuint batchProgram; // identyfikator programu cieniowania dla statycznego batcha
+
+GLuint multiDrawProgram; // identyfikator programu cieniowania dla glMultiDrawArraysIndirect (0 - brak obslugi)
+
+GLuint tilesProgram; // identyfikator programu cieniowania rozwijajacego punkty w kafelki (shader geometrii)
+
+GLuint tilesSquareMatrixLoc; // lokalizacja zmiennej jednorodnej - macierz kwadratu wzgledem srodka kafelka
+GLuint tilesTriangleMatricesLoc; // lokalizacja zmiennej jednorodnej - macierze trojkatow wzgledem srodka kafelka
+GLuint tilesSquareColorLoc; // lokalizacja zmiennej jednorodnej - kolor kwadratu
+GLuint tilesTriangleColorLoc; // lokalizacja zmiennej jednorodnej - kolor trojkatow
 
 GLuint vertexLoc; // lokalizacja atrybutu wierzcholka - wspolrzedne wierzcholkow
 GLuint colorLoc; // lokalizacja zmiennej jednorodnej - kolor rysowania prymitywu
 
 GLuint mvMatrixLoc; // lokalizacja zmiennej jednorodnej - macierz model-widok
 
-glm::mat4 mvMatrix; // macierz model-widok
-
-GLuint vao[2]; // identyfikatory VAO
-GLuint buffers[2]; // identyfikatory VBO
+std::vector<Affine2D> drawMatrices; // macierze model-widok kwadratow i trojkatow aktualnej siatki (SUBMIT_INDIVIDUAL)
+Affine2D shapeMatricesFrame[5]; // macierze kwadratu i trojkatow wzgledem srodka kafelka aktualnej siatki (SUBMIT_GEOMETRY)
+
+Material squareMaterial; // kolor kwadratow (SUBMIT_INDIVIDUAL)
+Material triangleMaterial; // kolor trojkatow (SUBMIT_INDIVIDUAL)
+Material gridSquaresMaterial; // kwadraty w gridProgram (SUBMIT_INSTANCE_ID)
+Material gridTrianglesMaterial; // trojkaty w gridProgram (SUBMIT_INSTANCE_ID)
+Material tilesMaterial; // macierze i kolory ksztaltow kafelka (SUBMIT_GEOMETRY)
+
+GLuint vao[5]; // identyfikatory VAO (trojkat, kwadrat, trojkaty instancyjnie, kwadraty instancyjnie, srodki kafelkow)
+GLuint buffers[5]; // identyfikatory VBO (trojkat, kwadrat, instancje trojkatow, instancje kwadratow, srodki kafelkow)
+GLuint gridBlockBuffer; // identyfikator UBO z parametrami siatki
+GLuint multiDrawVao; // identyfikator VAO dla trybu SUBMIT_MULTI_DRAW
+GLuint multiDrawBuffers[3]; // identyfikatory buforow (wierzcholki kwadratu i trojkata, polecenia rysowania, dane rysowan)
+
+int gridSize = GRID_SIZE; // aktualna liczba kafelkow w wierszu i kolumnie
+GridLayout layout; // parametry rozmieszczenia kafelkow dla gridSize
+bool instancesValid = false; // czy bufory instancji odpowiadaja aktualnej siatce
+bool pointsValid = false; // czy bufor srodkow kafelkow odpowiada aktualnej siatce
+bool drawsValid = false; // czy bufory polecen i danych rysowan odpowiadaja aktualnej siatce
+bool queueValid = false; // czy posortowana kolejka rysowania odpowiada aktualnej siatce i trybowi
+StaticBatch batch; // wszystkie kafelki przeksztalcone do jednego bufora (pusty - do zbudowania)
+SubmitMode submitMode = SUBMIT_INSTANCED; // aktualny sposob wysylania kafelkow
+
+bool benchmark = false; // czy uruchomic pomiar wydajnosci sposobow rysowania i zakonczyc program (--benchmark)
+
+GpuTimer gpuTimer; // pomiar czasu rysowania na GPU
+StateCache glState; // pamiec podreczna stanu OpenGL - pomija wywolania, ktore nic nie zmieniaja
+RenderQueue renderQueue; // kolejka rysowania sortowana wedlug stanu
 //******************************************************************************************
 
 void errorCallback(int error, const char* description);
@@ -43,13 +162,45 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 void onShutdown();
 void initGL();
 void setupShaders();
+void setupMaterials();
 void setupBuffers();
+void setupInstanceBuffers();
+void setupPointBuffer();
+void setupStaticBatch();
+void setupMultiDrawBuffers();
 void renderScene();
+void renderIndividual();
+void renderInstanced();
+void renderInstanceId();
+void renderGeometry();
+void renderStaticBatch();
+void renderMultiDraw();
+void runBenchmark(GLFWwindow* window);
+
+void updateLayout();
+void tileMatrices(int row, int column, Affine2D& square, Affine2D triangles[4]);
+void shapeMatrices(const Affine2D& tileMatrix, Affine2D& square, Affine2D triangles[4]);
+void changeGridSize(int newGridSize);
+void changeSubmitMode(SubmitMode newMode);
+int gridLimit(SubmitMode mode);
+bool submitModeAvailable(SubmitMode mode);
+void parseIntOption(const char* name, const char* text, int minValue, int maxValue, int& value);
 
 int main(int argc, char* argv[])
 {
 	atexit(onShutdown);
 
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--benchmark")
+			benchmark = true;
+		else if (std::string(argv[i]) == "--grid" && i + 1 < argc)
+			parseIntOption("--grid", argv[++i], 1, GRID_LIMIT_BUFFERLESS, gridSize);
+	}
+
+	if (gridSize > gridLimit(submitMode)) // tak duza siatke rysuje tylko tryb bez buforow instancji
+		submitMode = SUBMIT_INSTANCE_ID;
+
 	GLFWwindow* window;
 
 	glfwSetErrorCallback(errorCallback);
@@ -87,10 +238,16 @@ int main(int argc, char* argv[])
 		exit(2);
 	}
 
-	glfwSwapInterval(1); // v-sync on
+	glfwSwapInterval(benchmark ? 0 : 1); // v-sync on (wylaczony podczas pomiarow)
 
 	initGL();
 
+	if (benchmark)
+	{
+		runBenchmark(window);
+		glfwSetWindowShouldClose(window, GLFW_TRUE);
+	}
+
 	while (!glfwWindowShouldClose(window))
 	{
 		renderScene();
@@ -126,8 +283,35 @@ void errorCallback(int error, const char* description)
 **------------------------------------------------------------------------------------------*/
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
-	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
-		glfwSetWindowShouldClose(window, GLFW_TRUE);
+	if (action == GLFW_PRESS || action == GLFW_REPEAT)
+	{
+		switch (key)
+		{
+		case GLFW_KEY_ESCAPE:
+			glfwSetWindowShouldClose(window, GLFW_TRUE);
+			break;
+
+		case GLFW_KEY_F2:
+		{
+			SubmitMode mode = submitMode;
+
+			do
+				mode = static_cast<SubmitMode>((mode + 1) % SUBMIT_MODES);
+			while (!submitModeAvailable(mode));
+
+			changeSubmitMode(mode);
+			break;
+		}
+
+		case GLFW_KEY_RIGHT_BRACKET: // ] - wiecej kafelkow
+			changeGridSize(glm::min(2 * gridSize, gridLimit(submitMode)));
+			break;
+
+		case GLFW_KEY_LEFT_BRACKET: // [ - mniej kafelkow
+			changeGridSize(glm::max(gridSize / 2, 1));
+			break;
+		}
+	}
 }
 
 /*------------------------------------------------------------------------------------------
@@ -135,9 +319,26 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 **------------------------------------------------------------------------------------------*/
 void onShutdown()
 {
-	glDeleteBuffers(2, buffers);
-	glDeleteVertexArrays(2, vao);
+	glDeleteBuffers(5, buffers);
+	glDeleteBuffers(1, &gridBlockBuffer);
+	glDeleteVertexArrays(5, vao);
 	glDeleteProgram(shaderProgram);
+	glDeleteProgram(instancedProgram);
+	glDeleteProgram(gridProgram);
+	glDeleteProgram(tilesProgram);
+	glDeleteProgram(batchProgram);
+
+	if (multiDrawProgram != 0)
+	{
+		glDeleteBuffers(3, multiDrawBuffers);
+		glDeleteVertexArrays(1, &multiDrawVao);
+		glDeleteProgram(multiDrawProgram);
+	}
+
+	batch.destroy();
+	gpuTimer.destroy();
+
+	glState.printStats("Stan OpenGL");
 }
 
 /*------------------------------------------------------------------------------------------
@@ -156,7 +357,11 @@ void initGL()
 
 	setupShaders();
 
+	setupMaterials();
+
 	setupBuffers();
+
+	gpuTimer.init();
 }
 
 /*------------------------------------------------------------------------------------------
@@ -171,23 +376,62 @@ void setupShaders()
 	colorLoc = glGetUniformLocation(shaderProgram, "color");
 
 	mvMatrixLoc = glGetUniformLocation(shaderProgram, "modelViewMatrix");
+
+	if (!setupShaders("shaders/instanced.vert", "shaders/instanced.frag", instancedProgram))
+		exit(3);
+
+	if (!setupShaders("shaders/grid.vert", "shaders/instanced.frag", gridProgram))
+		exit(3);
+
+	gridTrianglesLoc = glGetUniformLocation(gridProgram, "triangles");
+	glUniformBlockBinding(gridProgram, glGetUniformBlockIndex(gridProgram, "GridBlock"), GRID_BLOCK_BINDING);
+
+	if (!setupShaders("shaders/tiles.vert", "shaders/tiles.geom", "shaders/instanced.frag", tilesProgram))
+		exit(3);
+
+	tilesSquareMatrixLoc = glGetUniformLocation(tilesProgram, "squareMatrix");
+	tilesTriangleMatricesLoc = glGetUniformLocation(tilesProgram, "triangleMatrices");
+	tilesSquareColorLoc = glGetUniformLocation(tilesProgram, "squareColor");
+	tilesTriangleColorLoc = glGetUniformLocation(tilesProgram, "triangleColor");
+
+	if (!setupShaders("shaders/batch.vert", "shaders/instanced.frag", batchProgram))
+		exit(3);
+
+	// tryb SUBMIT_MULTI_DRAW wymaga OpenGL 4.3 i gl_DrawIDARB - bez nich jest pomijany
+	if (!multiDrawSupported())
+		std::cout << "Brak OpenGL 4.3 lub ARB_shader_draw_parameters - tryb " << SUBMIT_MODE_NAMES[SUBMIT_MULTI_DRAW] << " niedostepny\n";
+	else if (!setupShaders("shaders/multidraw.vert", "shaders/instanced.frag", multiDrawProgram))
+		exit(3);
 }
 
 /*------------------------------------------------------------------------------------------
-** funkcja inicjujaca VAO oraz zawarte w nim VBO z danymi o modelu
+** funkcja przygotowuje materialy (zestawy zmiennych jednorodnych) rysowan wysylanych do
+** kolejki rysowania
 **------------------------------------------------------------------------------------------*/
-void setupBuffers()
+void setupMaterials()
 {
-	glGenVertexArrays(2, vao); // generowanie identyfikatora VAO
-	glGenBuffers(2, buffers); // generowanie identyfikatorow VBO
+	squareMaterial.uniforms = { { static_cast<GLint>(colorLoc), UNIFORM_VEC4, 1, SQUARE_COLOR } };
+	triangleMaterial.uniforms = { { static_cast<GLint>(colorLoc), UNIFORM_VEC4, 1, TRIANGLE_COLOR } };
+
+	gridSquaresMaterial.uniforms = { { static_cast<GLint>(gridTrianglesLoc), UNIFORM_INT, 1, &GRID_SQUARES } };
+	gridTrianglesMaterial.uniforms = { { static_cast<GLint>(gridTrianglesLoc), UNIFORM_INT, 1, &GRID_TRIANGLES } };
 
-	// wspolrzedne wierzcholkow trojkata
-	const float TRAINGLE_VERTICES[] =
+	tilesMaterial.uniforms =
 	{
-		0.0f, 0.25f, 0.0f, 1.0f,
-		-0.25f, -0.25f, 0.0f, 1.0f,
-		0.25f, -0.25f, 0.0f, 1.0f
+		{ static_cast<GLint>(tilesSquareMatrixLoc), UNIFORM_MAT3X2, 1, glm::value_ptr(shapeMatricesFrame[0]) },
+		{ static_cast<GLint>(tilesTriangleMatricesLoc), UNIFORM_MAT3X2, 4, glm::value_ptr(shapeMatricesFrame[1]) },
+		{ static_cast<GLint>(tilesSquareColorLoc), UNIFORM_VEC4, 1, SQUARE_COLOR },
+		{ static_cast<GLint>(tilesTriangleColorLoc), UNIFORM_VEC4, 1, TRIANGLE_COLOR }
 	};
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja inicjujaca VAO oraz zawarte w nim VBO z danymi o modelu
+**------------------------------------------------------------------------------------------*/
+void setupBuffers()
+{
+	glGenVertexArrays(5, vao); // generowanie identyfikatora VAO
+	glGenBuffers(5, buffers); // generowanie identyfikatorow VBO
 
 	glBindVertexArray(vao[0]); // dowiazanie pierwszego VAO    	
 
@@ -195,16 +439,7 @@ void setupBuffers()
 	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(TRAINGLE_VERTICES), TRAINGLE_VERTICES, GL_STATIC_DRAW);
 	glEnableVertexAttribArray(vertexLoc); // wlaczenie tablicy atrybutu wierzcholka - wspolrzedne
-	glVertexAttribPointer(vertexLoc, 4, GL_FLOAT, GL_FALSE, 0, 0); // zdefiniowanie danych tablicy atrybutu wierzchoka - wspolrzedne
-
-	// wspolrzedne wierzcholkow kwadratu
-	const float SQUARE_VERTICES[] =
-	{
-		-0.5f, 0.5f, 0.0f, 1.0f,
-		-0.5f, -0.5f, 0.0f, 1.0f,
-		0.5f, 0.5f, 0.0f, 1.0f,
-		0.5f, -0.5f, 0.0f, 1.0f
-	};
+	glVertexAttribPointer(vertexLoc, 2, GL_FLOAT, GL_FALSE, 0, 0); // zdefiniowanie danych tablicy atrybutu wierzchoka - wspolrzedne
 
 	glBindVertexArray(vao[1]); // dowiazanie pierwszego VAO    	
 
@@ -212,63 +447,683 @@ void setupBuffers()
 	glBindBuffer(GL_ARRAY_BUFFER, buffers[1]);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(SQUARE_VERTICES), SQUARE_VERTICES, GL_STATIC_DRAW);
 	glEnableVertexAttribArray(vertexLoc); // wlaczenie tablicy atrybutu wierzcholka - wspolrzedne
-	glVertexAttribPointer(vertexLoc, 4, GL_FLOAT, GL_FALSE, 0, 0); // zdefiniowanie danych tablicy atrybutu wierzchoka - wspolrzedne
+	glVertexAttribPointer(vertexLoc, 2, GL_FLOAT, GL_FALSE, 0, 0); // zdefiniowanie danych tablicy atrybutu wierzchoka - wspolrzedne
 
 	glBindVertexArray(0);
+
+	// UBO z parametrami siatki dla trybu SUBMIT_INSTANCE_ID
+	glGenBuffers(1, &gridBlockBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, gridBlockBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(GridBlock), nullptr, GL_STATIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, GRID_BLOCK_BINDING, gridBlockBuffer);
+
+	// VAO z samymi wspolrzednymi wierzcholkow dla rysowania instancyjnego; bufory instancji
+	// wypelniane sa przy pierwszym uzyciu trybu SUBMIT_INSTANCED
+	for (int shape = 0; shape < 2; shape++)
+	{
+		glBindVertexArray(vao[2 + shape]);
+
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[shape]);
+		glEnableVertexAttribArray(vertexLoc);
+		glVertexAttribPointer(vertexLoc, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	}
+
+	// VAO ze srodkami kafelkow (po jednym punkcie na kafelek) dla trybu SUBMIT_GEOMETRY;
+	// bufor wypelniany jest przy pierwszym uzyciu tego trybu
+	glBindVertexArray(vao[4]);
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[4]);
+	glEnableVertexAttribArray(vertexLoc);
+	glVertexAttribPointer(vertexLoc, 2, GL_FLOAT, GL_FALSE, 0, 0);
+
+	// VAO z wierzcholkami kwadratu (6, lista trojkatow) i trojkata (3) w jednym buforze dla
+	// trybu SUBMIT_MULTI_DRAW; polecenia i dane rysowan wypelniane sa przy pierwszym uzyciu
+	if (multiDrawProgram != 0)
+	{
+		std::vector<glm::vec4> vertices = makeBatchShape(SQUARE_VERTICES, 4, 2, GL_TRIANGLE_STRIP).vertices;
+		const std::vector<glm::vec4> triangle = makeBatchShape(TRAINGLE_VERTICES, 3, 2, GL_TRIANGLES).vertices;
+		vertices.insert(vertices.end(), triangle.begin(), triangle.end());
+
+		glGenVertexArrays(1, &multiDrawVao);
+		glGenBuffers(3, multiDrawBuffers);
+
+		glBindVertexArray(multiDrawVao);
+
+		glBindBuffer(GL_ARRAY_BUFFER, multiDrawBuffers[0]);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec4), vertices.data(), GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), 0);
+	}
+
+	glBindVertexArray(0);
+
+	updateLayout();
+
+	glState.invalidate(); // VAO i bufory dowiazywane byly z pominieciem glState
 }
 
 /*------------------------------------------------------------------------------------------
-** funkcja rysujaca scene
+** funkcja wypelnia bufory instancji kwadratow i trojkatow dla aktualnego rozmiaru siatki
+** oraz inicjuje VAO do rysowania instancyjnego (wspolrzedne wierzcholkow wspolne z VAO
+** rysowania pojedynczego, macierz i kolor zmieniaja sie co instancje)
 **------------------------------------------------------------------------------------------*/
-void renderScene()
+void setupInstanceBuffers()
 {
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	Stopwatch stopwatch;
+
+	const int tiles = gridSize * gridSize;
+
+	for (int shape = 0; shape < 2; shape++) // 0 - trojkaty, 1 - kwadraty
+	{
+		glBindVertexArray(vao[2 + shape]);
+
+		// VBO z danymi instancji, wypelniany bezposrednio w zmapowanej pamieci
+		const int instances = (shape == 0) ? 4 * tiles : tiles;
+
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[2 + shape]);
+		fillBuffer<TileInstance>(GL_ARRAY_BUFFER, instances * sizeof(TileInstance), [shape](TileInstance* data)
+		{
+			const float* color = (shape == 0) ? TRIANGLE_COLOR : SQUARE_COLOR;
+			const GLubyte packed[4] = { GLubyte(color[0] * 255), GLubyte(color[1] * 255), GLubyte(color[2] * 255), GLubyte(color[3] * 255) };
+
+			#pragma omp parallel for
+			for (int i = 0; i < gridSize; i++)
+			{
+				for (int j = 0; j < gridSize; j++)
+				{
+					Affine2D square, triangles[4];
+					tileMatrices(i, j, square, triangles);
+
+					const int tile = i * gridSize + j;
+
+					for (int k = 0; k < ((shape == 0) ? 4 : 1); k++)
+					{
+						TileInstance& instance = data[(shape == 0) ? 4 * tile + k : tile];
+
+						instance.mvMatrix = (shape == 0) ? triangles[k] : square;
+						std::copy(packed, packed + 4, instance.color);
+					}
+				}
+			}
+		});
+
+		for (int c = 0; c < 3; c++) // macierz 3x2 zajmuje trzy kolejne lokalizacje atrybutow
+		{
+			glEnableVertexAttribArray(1 + c);
+			glVertexAttribPointer(1 + c, 2, GL_FLOAT, GL_FALSE, sizeof(TileInstance), reinterpret_cast<void*>(offsetof(TileInstance, mvMatrix) + c * sizeof(glm::vec2)));
+			glVertexAttribDivisor(1 + c, 1);
+		}
+
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TileInstance), reinterpret_cast<void*>(offsetof(TileInstance, color)));
+		glVertexAttribDivisor(4, 1);
+	}
+
+	glBindVertexArray(0);
+
+	instancesValid = true;
+	glState.invalidate();
+
+	std::cout << "Siatka " << gridSize << "x" << gridSize << ": " << 5 * tiles << " instancji, " << stopwatch.elapsedMs() << " ms" << std::endl;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wypelnia bufor srodkow kafelkow (x, y) dla aktualnego rozmiaru siatki - kwadrat
+** i trojkaty kafelka tworzy z punktu shader geometrii
+**------------------------------------------------------------------------------------------*/
+void setupPointBuffer()
+{
+	Stopwatch stopwatch;
 
-	glUseProgram(shaderProgram);
+	const int tiles = gridSize * gridSize;
 
-	float x = -OFFSET, y = OFFSET;
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[4]);
+	fillBuffer<glm::vec2>(GL_ARRAY_BUFFER, tiles * sizeof(glm::vec2), [](glm::vec2* data)
+	{
+		#pragma omp parallel for
+		for (int i = 0; i < gridSize; i++)
+		{
+			for (int j = 0; j < gridSize; j++)
+				data[i * gridSize + j] = glm::vec2(-layout.offset + j * layout.diff, layout.offset - i * layout.diff);
+		}
+	});
+
+	pointsValid = true;
+	glState.invalidate();
+
+	std::cout << "Siatka " << gridSize << "x" << gridSize << ": " << tiles << " punktow, " << stopwatch.elapsedMs() << " ms" << std::endl;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja buduje statyczny batch calej siatki - macierze kafelkow liczone sa rownolegle,
+** a batch przeksztalca nimi wierzcholki kwadratow i trojkatow do jednego bufora
+**------------------------------------------------------------------------------------------*/
+void setupStaticBatch()
+{
+	const std::vector<BatchShape> shapes =
+	{
+		makeBatchShape(SQUARE_VERTICES, 4, 2, GL_TRIANGLE_STRIP),
+		makeBatchShape(TRAINGLE_VERTICES, 3, 2, GL_TRIANGLES)
+	};
+
+	const GLubyte squareColor[4] = { GLubyte(SQUARE_COLOR[0] * 255), GLubyte(SQUARE_COLOR[1] * 255), GLubyte(SQUARE_COLOR[2] * 255), GLubyte(SQUARE_COLOR[3] * 255) };
+	const GLubyte triangleColor[4] = { GLubyte(TRIANGLE_COLOR[0] * 255), GLubyte(TRIANGLE_COLOR[1] * 255), GLubyte(TRIANGLE_COLOR[2] * 255), GLubyte(TRIANGLE_COLOR[3] * 255) };
+
+	std::vector<BatchObject> objects(5 * gridSize * gridSize); // kwadrat i cztery trojkaty na kafelek
+
+	#pragma omp parallel for
+	for (int i = 0; i < gridSize; i++)
+	{
+		Affine2D square;
+		Affine2D triangles[4];
+
+		for (int j = 0; j < gridSize; j++)
+		{
+			tileMatrices(i, j, square, triangles);
+
+			BatchObject* tile = &objects[5 * (i * gridSize + j)];
+
+			tile[0].matrix = affineToMat4(square);
+			tile[0].shape = 0;
+			std::copy(squareColor, squareColor + 4, tile[0].color);
+
+			for (int k = 0; k < 4; k++)
+			{
+				tile[1 + k].matrix = affineToMat4(triangles[k]);
+				tile[1 + k].shape = 1;
+				std::copy(triangleColor, triangleColor + 4, tile[1 + k].color);
+			}
+		}
+	}
+
+	batch.build(shapes, objects, 0, 1);
+
+	glState.invalidate();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wypelnia bufor polecen rysowania posredniego (kwadrat i cztery trojkaty na
+** kafelek) oraz SSBO z macierzami i kolorami kolejnych rysowan, wybieranymi w shaderze
+** przez gl_DrawIDARB
+**------------------------------------------------------------------------------------------*/
+void setupMultiDrawBuffers()
+{
+	Stopwatch stopwatch;
+
+	const int tiles = gridSize * gridSize;
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, multiDrawBuffers[1]);
+	fillBuffer<DrawArraysIndirectCommand>(GL_DRAW_INDIRECT_BUFFER, 5 * tiles * sizeof(DrawArraysIndirectCommand), [tiles](DrawArraysIndirectCommand* data)
+	{
+		#pragma omp parallel for
+		for (int tile = 0; tile < tiles; tile++)
+		{
+			data[5 * tile] = { 6, 1, 0, 0 }; // kwadrat - wierzcholki 0-5
+
+			for (int k = 1; k < 5; k++)
+				data[5 * tile + k] = { 3, 1, 6, 0 }; // trojkat - wierzcholki 6-8
+		}
+	});
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, multiDrawBuffers[2]);
+	fillBuffer<TileDraw>(GL_SHADER_STORAGE_BUFFER, 5 * tiles * sizeof(TileDraw), [](TileDraw* data)
+	{
+		const GLubyte squareColor[4] = { GLubyte(SQUARE_COLOR[0] * 255), GLubyte(SQUARE_COLOR[1] * 255), GLubyte(SQUARE_COLOR[2] * 255), GLubyte(SQUARE_COLOR[3] * 255) };
+		const GLubyte triangleColor[4] = { GLubyte(TRIANGLE_COLOR[0] * 255), GLubyte(TRIANGLE_COLOR[1] * 255), GLubyte(TRIANGLE_COLOR[2] * 255), GLubyte(TRIANGLE_COLOR[3] * 255) };
+
+		#pragma omp parallel for
+		for (int i = 0; i < gridSize; i++)
+		{
+			Affine2D square;
+			Affine2D triangles[4];
+
+			for (int j = 0; j < gridSize; j++)
+			{
+				tileMatrices(i, j, square, triangles);
+
+				TileDraw* tile = &data[5 * (i * gridSize + j)];
+
+				tile[0].mvMatrix = square;
+				std::copy(squareColor, squareColor + 4, tile[0].color);
+
+				for (int k = 0; k < 4; k++)
+				{
+					tile[1 + k].mvMatrix = triangles[k];
+					std::copy(triangleColor, triangleColor + 4, tile[1 + k].color);
+				}
+			}
+		}
+	});
+
+	drawsValid = true;
+	glState.invalidate();
+
+	std::cout << "Siatka " << gridSize << "x" << gridSize << ": " << 5 * tiles << " polecen rysowania, " << stopwatch.elapsedMs() << " ms" << std::endl;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja przelicza parametry rozmieszczenia kafelkow dla aktualnego rozmiaru siatki
+** (dla GRID_SIZE sa rowne OFFSET, DIFF, SCALE i TRIANGLE_OFFSET)
+**------------------------------------------------------------------------------------------*/
+void updateLayout()
+{
+	const float factor = static_cast<float>(GRID_SIZE) / gridSize;
+
+	layout.offset = OFFSET * factor * (gridSize - 1) / (GRID_SIZE - 1);
+	layout.diff = DIFF * factor;
+	layout.scale = SCALE * factor;
+	layout.triangleOffset = TRIANGLE_OFFSET * factor;
+
+	const GridBlock block =
+	{
+		glm::make_vec4(SQUARE_COLOR),
+		glm::make_vec4(TRIANGLE_COLOR),
+		layout.offset,
+		layout.diff,
+		layout.scale,
+		layout.triangleOffset,
+		glm::radians(ROTATION_OFFSET),
+		gridSize,
+		{}
+	};
+
+	glBindBuffer(GL_UNIFORM_BUFFER, gridBlockBuffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GridBlock), &block);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza macierze model-widok kwadratu i czterech trojkatow jednego kafelka
+** row, column - polozenie kafelka w siatce
+** square - macierz kwadratu
+** triangles - macierze trojkatow
+**------------------------------------------------------------------------------------------*/
+void tileMatrices(int row, int column, Affine2D& square, Affine2D triangles[4])
+{
+	const float x = -layout.offset + column * layout.diff;
+	const float y = layout.offset - row * layout.diff;
+
+	Affine2D tempMat = affineTranslate(affineIdentity(), glm::vec2(x, y)); // ustawia pozycje kwadratu
+
+	shapeMatrices(tempMat, square, triangles);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza macierze kwadratu i czterech trojkatow kafelka
+** tileMatrix - macierz ustawiajaca srodek kafelka (jednostkowa daje macierze wzgledem
+**              srodka kafelka, uzywane przez shader geometrii)
+** square - macierz kwadratu
+** triangles - macierze kolejnych trojkatow
+**------------------------------------------------------------------------------------------*/
+void shapeMatrices(const Affine2D& tileMatrix, Affine2D& square, Affine2D triangles[4])
+{
+	square = affineRotate(tileMatrix, glm::radians(-ROTATION_OFFSET));
+	square = affineScale(square, glm::vec2(layout.scale, layout.scale));
 
 	float rotation = 90.0f - ROTATION_OFFSET;
 
-	glm::mat4 tempMat;
+	for (int k = 0; k < 4; k++)
+	{
+		triangles[k] = affineRotate(tileMatrix, glm::radians(rotation));
+		triangles[k] = affineTranslate(triangles[k], glm::vec2(0.0f, -layout.triangleOffset)); // przesuniecie od srodka kwadratu
+
+		triangles[k] = affineScale(triangles[k], glm::vec2(layout.scale, layout.scale));
+
+		rotation -= 90.0f;
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zmienia rozmiar siatki kafelkow; bufory instancji sa zwalniane i zostana
+** wypelnione ponownie dopiero gdy beda potrzebne
+** newGridSize - nowa liczba kafelkow w wierszu i kolumnie
+**------------------------------------------------------------------------------------------*/
+void changeGridSize(int newGridSize)
+{
+	if (newGridSize == gridSize)
+		return;
+
+	gridSize = newGridSize;
+
+	updateLayout();
+
+	for (int buffer = 2; buffer < 5; buffer++) // bufory instancji i srodkow kafelkow
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[buffer]);
+		glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+	}
+
+	if (multiDrawProgram != 0) // polecenia i dane rysowan
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, multiDrawBuffers[1]);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, multiDrawBuffers[2]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+	}
+
+	instancesValid = false;
+	pointsValid = false;
+	drawsValid = false;
+
+	batch.destroy();
+
+	glState.invalidate(); // m.in. usuniete VAO batcha moglo byc dowiazane
+	queueValid = false;
+
+	std::cout << "Siatka " << gridSize << "x" << gridSize << std::endl;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zmienia sposob wysylania kafelkow, w razie potrzeby zmniejszajac siatke
+** newMode - nowy sposob wysylania kafelkow
+**------------------------------------------------------------------------------------------*/
+void changeSubmitMode(SubmitMode newMode)
+{
+	submitMode = newMode;
+	queueValid = false;
+
+	if (gridSize > gridLimit(submitMode))
+		changeGridSize(gridLimit(submitMode));
+
+	std::cout << "Tryb: " << SUBMIT_MODE_NAMES[submitMode] << std::endl;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca maksymalny rozmiar siatki dla danego sposobu wysylania kafelkow
+** mode - sposob wysylania kafelkow
+**------------------------------------------------------------------------------------------*/
+int gridLimit(SubmitMode mode)
+{
+	switch (mode)
+	{
+	case SUBMIT_INDIVIDUAL:
+		return GRID_LIMIT_INDIVIDUAL;
+
+	case SUBMIT_INSTANCE_ID:
+		return GRID_LIMIT_BUFFERLESS;
+
+	default:
+		return GRID_LIMIT;
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja sprawdza, czy dany sposob wysylania kafelkow jest obslugiwany przez kontekst
+** mode - sposob wysylania kafelkow
+**------------------------------------------------------------------------------------------*/
+bool submitModeAvailable(SubmitMode mode)
+{
+	return mode != SUBMIT_MULTI_DRAW || multiDrawProgram != 0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rysujaca scene
+**------------------------------------------------------------------------------------------*/
+void renderScene()
+{
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	gpuTimer.begin();
 
-	for (int i = 0; i < 5; i++)
+	// siatka jest statyczna - kolejka (wraz z macierzami kafelkow) budowana i sortowana
+	// jest tylko po zmianie rozmiaru siatki lub trybu, a w pozostalych klatkach jedynie
+	// wykonywana
+	if (!queueValid)
 	{
-		for (int j = 0; j < 5; j++)
+		renderQueue.clear();
+
+		switch (submitMode)
 		{
-			glBindVertexArray(vao[1]);
-			glUniform4fv(colorLoc, 1, SQUARE_COLOR);
+		case SUBMIT_INSTANCED:
+			renderInstanced();
+			break;
+
+		case SUBMIT_INSTANCE_ID:
+			renderInstanceId();
+			break;
 
-			mvMatrix = glm::mat4(1.0f);
-			mvMatrix = tempMat = glm::translate(mvMatrix, glm::vec3(x, y, 0.0f)); // ustawia pozycje kwadratu
-			mvMatrix = glm::rotate(mvMatrix, glm::radians(-ROTATION_OFFSET), glm::vec3(0.0f, 0.0f, 1.0f));
-			mvMatrix = glm::scale(mvMatrix, glm::vec3(SCALE, SCALE, 0.0f));
+		case SUBMIT_GEOMETRY:
+			renderGeometry();
+			break;
 
-			glUniformMatrix4fv(mvMatrixLoc, 1, GL_FALSE, glm::value_ptr(mvMatrix));
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		case SUBMIT_STATIC_BATCH:
+			renderStaticBatch();
+			break;
 
-			glBindVertexArray(vao[0]);
-			glUniform4fv(colorLoc, 1, TRIANGLE_COLOR);
+		case SUBMIT_MULTI_DRAW:
+			renderMultiDraw();
+			break;
+
+		default:
+			renderIndividual();
+			break;
+		}
+
+		renderQueue.sort();
+		queueValid = true;
+	}
+
+	renderQueue.execute(glState);
+
+	gpuTimer.end();
+	glState.endFrame();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wysyla do kolejki rysowania kazdy kwadrat i trojkat jako osobne wywolanie
+** glDrawArrays - kolejka grupuje je wedlug VAO i koloru, wiec stan zmienia sie dwa razy
+** na klatke zamiast dwa razy na kafelek
+**------------------------------------------------------------------------------------------*/
+void renderIndividual()
+{
+	drawMatrices.resize(5 * gridSize * gridSize);
+
+	RenderCommand square;
+	square.program = shaderProgram;
+	square.vertexArray = vao[1];
+	square.material = &squareMaterial;
+	square.objectUniform = { static_cast<GLint>(mvMatrixLoc), UNIFORM_MAT3X2, 1, nullptr };
+	square.mode = GL_TRIANGLE_STRIP;
+	square.count = 4;
+
+	RenderCommand triangle = square;
+	triangle.vertexArray = vao[0];
+	triangle.material = &triangleMaterial;
+	triangle.mode = GL_TRIANGLES;
+	triangle.count = 3;
+
+	for (int i = 0; i < gridSize; i++)
+	{
+		for (int j = 0; j < gridSize; j++)
+		{
+			Affine2D* matrices = &drawMatrices[5 * (i * gridSize + j)];
+			tileMatrices(i, j, matrices[0], matrices + 1);
+
+			square.objectUniform.value = glm::value_ptr(matrices[0]);
+			renderQueue.submit(square);
 
 			for (int k = 0; k < 4; k++)
 			{
-				mvMatrix = tempMat; // pozycja ostatniego kwadratu
+				triangle.objectUniform.value = glm::value_ptr(matrices[1 + k]);
+				renderQueue.submit(triangle);
+			}
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wysyla do kolejki rysowania wszystkie kwadraty i wszystkie trojkaty jako dwa
+** wywolania glDrawArraysInstanced (macierze i kolory pobierane z buforow instancji)
+**------------------------------------------------------------------------------------------*/
+void renderInstanced()
+{
+	const int tiles = gridSize * gridSize;
+
+	if (!instancesValid)
+		setupInstanceBuffers();
+
+	RenderCommand command;
+	command.program = instancedProgram;
+
+	command.vertexArray = vao[3];
+	command.mode = GL_TRIANGLE_STRIP;
+	command.count = 4;
+	command.instances = tiles;
+	renderQueue.submit(command);
+
+	command.vertexArray = vao[2];
+	command.mode = GL_TRIANGLES;
+	command.count = 3;
+	command.instances = 4 * tiles;
+	renderQueue.submit(command);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wysyla do kolejki rysowania dwa wywolania glDrawArraysInstanced bez buforow
+** instancji - shader wyznacza polozenie kafelka z gl_InstanceID i bloku GridBlock
+**------------------------------------------------------------------------------------------*/
+void renderInstanceId()
+{
+	const int tiles = gridSize * gridSize;
+
+	RenderCommand command;
+	command.program = gridProgram;
+
+	command.vertexArray = vao[3];
+	command.material = &gridSquaresMaterial;
+	command.mode = GL_TRIANGLE_STRIP;
+	command.count = 4;
+	command.instances = tiles;
+	renderQueue.submit(command);
+
+	command.vertexArray = vao[2];
+	command.material = &gridTrianglesMaterial;
+	command.mode = GL_TRIANGLES;
+	command.count = 3;
+	command.instances = 4 * tiles;
+	renderQueue.submit(command);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wysyla do kolejki rysowania jedno wywolanie glDrawArrays(GL_POINTS) - shader
+** geometrii rozwija kazdy punkt w kwadrat i cztery trojkaty, ktorych macierze wzgledem
+** srodka kafelka liczone sa tu raz na klatke
+**------------------------------------------------------------------------------------------*/
+void renderGeometry()
+{
+	if (!pointsValid)
+		setupPointBuffer();
+
+	shapeMatrices(affineIdentity(), shapeMatricesFrame[0], shapeMatricesFrame + 1);
+
+	RenderCommand command;
+	command.program = tilesProgram;
+	command.vertexArray = vao[4];
+	command.material = &tilesMaterial;
+	command.mode = GL_POINTS;
+	command.count = gridSize * gridSize;
+	renderQueue.submit(command);
+}
 
-				mvMatrix = glm::rotate(mvMatrix, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
-				mvMatrix = glm::translate(mvMatrix, glm::vec3(0.0f, -0.15f, 0.0f)); // przesuniecie od srodka kwadratu
+/*------------------------------------------------------------------------------------------
+** funkcja wysyla do kolejki rysowania cala siatke jako jedno wywolanie glDrawArrays ze
+** statycznego batcha
+**------------------------------------------------------------------------------------------*/
+void renderStaticBatch()
+{
+	if (batch.empty())
+		setupStaticBatch();
+
+	RenderCommand command;
+	command.program = batchProgram;
+	command.vertexArray = batch.vao;
+	command.count = batch.vertexCount;
+	renderQueue.submit(command);
+}
 
-				mvMatrix = glm::scale(mvMatrix, glm::vec3(SCALE, SCALE, 0.0f));
+/*------------------------------------------------------------------------------------------
+** funkcja wysyla do kolejki rysowania cala siatke jako jedno wywolanie
+** glMultiDrawArraysIndirect - kazdy kwadrat i trojkat jest osobnym poleceniem rysowania
+** z wlasnymi danymi w SSBO
+**------------------------------------------------------------------------------------------*/
+void renderMultiDraw()
+{
+	if (!drawsValid)
+		setupMultiDrawBuffers();
+
+	RenderCommand command;
+	command.program = multiDrawProgram;
+	command.vertexArray = multiDrawVao;
+	command.objectBuffer.target = GL_SHADER_STORAGE_BUFFER;
+	command.objectBuffer.index = DRAW_DATA_BINDING;
+	command.objectBuffer.buffer = multiDrawBuffers[2];
+	command.type = DRAW_ARRAYS_INDIRECT;
+	command.count = 5 * gridSize * gridSize;
+	command.indirectBuffer = multiDrawBuffers[1];
+	renderQueue.submit(command);
+}
 
-				glUniformMatrix4fv(mvMatrixLoc, 1, GL_FALSE, glm::value_ptr(mvMatrix));
-				glDrawArrays(GL_TRIANGLES, 0, 3);
+/*------------------------------------------------------------------------------------------
+** funkcja porownuje czas rysowania kafelkow kazdym ze sposobow dla coraz wiekszych siatek
+** i wyswietla wyniki
+** window - okno, w ktorym rysowana jest scena
+**------------------------------------------------------------------------------------------*/
+void runBenchmark(GLFWwindow* window)
+{
+	const int GRID_SIZES[] = { GRID_SIZE, 50, GRID_LIMIT_INDIVIDUAL, GRID_LIMIT, GRID_LIMIT_BUFFERLESS };
 
-				rotation -= 90.0f;
+	for (int size : GRID_SIZES)
+	{
+		changeGridSize(size);
+
+		for (int mode = 0; mode < SUBMIT_MODES; mode++)
+		{
+			if (gridSize > gridLimit(static_cast<SubmitMode>(mode)) || !submitModeAvailable(static_cast<SubmitMode>(mode)))
+				continue;
+
+			submitMode = static_cast<SubmitMode>(mode);
+			queueValid = false;
+
+			glFinish();
+			gpuTimer.reset();
+			glState.resetStats();
+			Stopwatch stopwatch;
+
+			for (int frame = 0; frame < BENCHMARK_FRAMES && !glfwWindowShouldClose(window); frame++)
+			{
+				renderScene();
+
+				glfwSwapBuffers(window);
+				glfwPollEvents();
 			}
-			x += DIFF;
+
+			glFinish();
+
+			std::cout << "[benchmark] " << gridSize << "x" << gridSize << " " << SUBMIT_MODE_NAMES[mode] << ": GPU " << gpuTimer.averageMs()
+				<< " ms, klatka " << stopwatch.elapsedMs() / BENCHMARK_FRAMES << " ms" << std::endl;
+			glState.printStats("[benchmark] stan OpenGL");
 		}
-		x = -OFFSET;
-		y -= DIFF;
 	}
+}
 
-	glBindVertexArray(0);
-}
\ No newline at end of file
+/*------------------------------------------------------------------------------------------
+** funkcja odczytuje liczbe calkowita z argumentu wiersza polecen i ogranicza ja do
+** przedzialu [minValue, maxValue] (rowniez liczby spoza zakresu typu long); argument,
+** ktory nie jest liczba, pozostawia dotychczasowa wartosc
+** name - nazwa opcji (do komunikatu)
+** text - argument opcji
+** minValue, maxValue - dopuszczalny przedzial wartosci
+** value - wartosc opcji
+**------------------------------------------------------------------------------------------*/
+void parseIntOption(const char* name, const char* text, int minValue, int maxValue, int& value)
+{
+	char* end = nullptr;
+	const long parsed = std::strtol(text, &end, 10); // poza zakresem long - LONG_MIN lub LONG_MAX
+
+	if (end == text || *end != '\0')
+	{
+		std::cout << "Niepoprawna wartosc opcji " << name << ": \"" << text << "\", pozostaje " << value << "\n";
+		return;
+	}
+
+	value = static_cast<int>(glm::clamp(parsed, static_cast<long>(minValue), static_cast<long>(maxValue)));
+}
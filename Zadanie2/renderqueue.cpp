@@ -0,0 +1,197 @@
+#include <algorithm>
+
+#include "renderqueue.h"
+
+const int KEY_PASS_BITS = 4;
+const int KEY_PROGRAM_BITS = 8;
+const int KEY_VERTEX_ARRAY_BITS = 12;
+const int KEY_MATERIAL_BITS = 12;
+const int KEY_DEPTH_BITS = 28;
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca numer wartosci w tablicy slotow, dopisujac ja przy pierwszym uzyciu;
+** po zapelnieniu tablicy kolejne wartosci dostaja ostatni numer - klucze sa wtedy mniej
+** zroznicowane (wiecej zmian stanu), ale kolejnosc przebiegow i glebokosci jest zachowana
+** slots - tablica slotow
+** value - wartosc (program, VAO lub material)
+** bits - liczba bitow klucza na numer slotu
+**------------------------------------------------------------------------------------------*/
+template <typename T>
+static GLuint64 slot(std::vector<T>& slots, T value, int bits)
+{
+	auto found = std::find(slots.begin(), slots.end(), value);
+	if (found != slots.end())
+		return found - slots.begin();
+
+	if (slots.size() >= (1u << bits))
+		return slots.size() - 1;
+
+	slots.push_back(value);
+	return slots.size() - 1;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa rysowania z kolejki - numery stanow w kluczu potrzebne sa tylko do jednego
+** sortowania, wiec tablice slotow tez sa czyszczone (nazwy usunietych VAO i programow nie
+** zajmuja numerow, a przebudowa buforow nie zapelnia tablic)
+**------------------------------------------------------------------------------------------*/
+void RenderQueue::clear()
+{
+	commands.clear();
+	items.clear();
+
+	programs.clear();
+	vertexArrays.clear();
+	materials.clear();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja dodaje rysowanie do kolejki
+** command - rysowanie
+** pass - numer przebiegu (0 - 15), przebiegi wykonywane sa w kolejnosci numerow
+** depth - glebokosc w zakresie [0, 1], w ramach tego samego stanu rysowania wykonywane sa
+**         od najblizszego
+**------------------------------------------------------------------------------------------*/
+void RenderQueue::submit(const RenderCommand& command, int pass, float depth)
+{
+	const GLuint64 depthBits = static_cast<GLuint64>(std::min(std::max(depth, 0.0f), 1.0f) * ((1 << KEY_DEPTH_BITS) - 1));
+
+	GLuint64 key = static_cast<GLuint64>(pass & ((1 << KEY_PASS_BITS) - 1));
+	key = (key << KEY_PROGRAM_BITS) | slot(programs, command.program, KEY_PROGRAM_BITS);
+	key = (key << KEY_VERTEX_ARRAY_BITS) | slot(vertexArrays, command.vertexArray, KEY_VERTEX_ARRAY_BITS);
+	key = (key << KEY_MATERIAL_BITS) | slot(materials, command.material, KEY_MATERIAL_BITS);
+	key = (key << KEY_DEPTH_BITS) | depthBits;
+
+	items.push_back({ key, static_cast<GLuint>(commands.size()) });
+	commands.push_back(command);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja sortuje rysowania wedlug kluczy - sortowanie pozycyjne od najmlodszego bajtu
+** (8 przebiegow po 256 kubelkow); przebiegi, w ktorych wszystkie klucze maja ten sam bajt,
+** sa pomijane, wiec dla malo zroznicowanych kluczy sortowanie jest kilka razy krotsze
+**------------------------------------------------------------------------------------------*/
+void RenderQueue::sort()
+{
+	const size_t count = items.size();
+	if (count == 0)
+		return;
+
+	scratch.resize(count);
+
+	size_t histograms[8][256] = {};
+
+	for (const SortItem& item : items)
+	{
+		for (int byte = 0; byte < 8; byte++)
+			histograms[byte][(item.key >> (8 * byte)) & 0xFF]++;
+	}
+
+	for (int byte = 0; byte < 8; byte++)
+	{
+		size_t* histogram = histograms[byte];
+
+		if (histogram[(items[0].key >> (8 * byte)) & 0xFF] == count) // wszystkie klucze maja ten sam bajt
+			continue;
+
+		size_t offset = 0;
+		for (int bucket = 0; bucket < 256; bucket++)
+		{
+			const size_t size = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += size;
+		}
+
+		for (const SortItem& item : items)
+			scratch[histogram[(item.key >> (8 * byte)) & 0xFF]++] = item;
+
+		items.swap(scratch);
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja ustawia zmienna jednorodna aktualnego programu
+**------------------------------------------------------------------------------------------*/
+static void applyUniform(StateCache& state, const Uniform& uniform)
+{
+	switch (uniform.type)
+	{
+	case UNIFORM_INT:
+		state.uniform1i(uniform.location, *static_cast<const GLint*>(uniform.value));
+		break;
+
+	case UNIFORM_VEC4:
+		state.uniform4fv(uniform.location, static_cast<const GLfloat*>(uniform.value));
+		break;
+
+	case UNIFORM_MAT3X2:
+		state.uniformMatrix3x2fv(uniform.location, uniform.count, static_cast<const GLfloat*>(uniform.value));
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wykonuje rysowania w kolejnosci kluczy; caly stan ustawiany jest przez state,
+** ktory pomija zmiany powtarzajace sie miedzy kolejnymi rysowaniami
+** state - pamiec podreczna stanu OpenGL
+**------------------------------------------------------------------------------------------*/
+void RenderQueue::execute(StateCache& state) const
+{
+	for (const SortItem& item : items)
+	{
+		const RenderCommand& command = commands[item.command];
+
+		state.useProgram(command.program);
+		state.bindVertexArray(command.vertexArray);
+
+		if (command.material != nullptr)
+		{
+			for (const Uniform& uniform : command.material->uniforms)
+				applyUniform(state, uniform);
+		}
+
+		if (command.objectUniform.location != -1)
+			applyUniform(state, command.objectUniform);
+
+		if (command.objectBuffer.buffer != 0)
+			state.bindBufferRange(command.objectBuffer);
+
+		switch (command.type)
+		{
+		case DRAW_ARRAYS:
+			if (command.instances == 1)
+				glDrawArrays(command.mode, static_cast<GLint>(command.first), command.count);
+			else
+				glDrawArraysInstanced(command.mode, static_cast<GLint>(command.first), command.count, command.instances);
+			break;
+
+		case DRAW_ELEMENTS:
+			if (command.instances == 1)
+				glDrawElements(command.mode, command.count, GL_UNSIGNED_INT, reinterpret_cast<const void*>(command.first));
+			else
+				glDrawElementsInstanced(command.mode, command.count, GL_UNSIGNED_INT, reinterpret_cast<const void*>(command.first), command.instances);
+			break;
+
+		case DRAW_ARRAYS_INDIRECT:
+			state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, command.indirectBuffer);
+			glMultiDrawArraysIndirect(command.mode, reinterpret_cast<const void*>(command.first), command.count, 0);
+			break;
+
+		case DRAW_ELEMENTS_INDIRECT:
+			state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, command.indirectBuffer);
+			glMultiDrawElementsIndirect(command.mode, GL_UNSIGNED_INT, reinterpret_cast<const void*>(command.first), command.count, 0);
+			break;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja sortuje i wykonuje rysowania, a nastepnie oproznia kolejke
+** state - pamiec podreczna stanu OpenGL
+**------------------------------------------------------------------------------------------*/
+void RenderQueue::flush(StateCache& state)
+{
+	sort();
+	execute(state);
+	clear();
+}
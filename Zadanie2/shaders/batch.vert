@@ -0,0 +1,12 @@
+#version 330
+
+layout(location = 0) in vec4 vPosition; // pozycja wierzcholka juz przeksztalcona na CPU
+layout(location = 1) in vec4 vertexColor; // kolor wierzcholka
+
+out vec4 vColor;
+
+void main()
+{
+	gl_Position = vPosition;
+	vColor = vertexColor;
+}
\ No newline at end of file
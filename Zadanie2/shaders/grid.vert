@@ -0,0 +1,48 @@
+#version 330
+
+// parametry siatki kafelkow - polozenie kafelka wyznaczane jest z gl_InstanceID
+layout(std140) uniform GridBlock
+{
+	vec4 squareColor;
+	vec4 triangleColor;
+	float offset;
+	float diff;
+	float scale;
+	float triangleOffset;
+	float rotationOffset; // w radianach
+	int gridSize;
+};
+
+uniform bool triangles; // czy rysowane sa trojkaty (4 instancje na kafelek) czy kwadraty
+
+layout(location = 0) in vec2 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
+
+out vec4 vColor;
+
+mat2 rotation(float angle)
+{
+	float c = cos(angle), s = sin(angle);
+	return mat2(c, s, -s, c);
+}
+
+void main()
+{
+	int tile = triangles ? gl_InstanceID / 4 : gl_InstanceID;
+	vec2 center = vec2(-offset + (tile % gridSize) * diff, offset - (tile / gridSize) * diff);
+
+	vec2 position = scale * vPosition;
+
+	if (triangles)
+	{
+		float angle = radians(90.0) * float(1 - gl_InstanceID % 4) - rotationOffset;
+		position = rotation(angle) * (position + vec2(0.0, -triangleOffset));
+		vColor = triangleColor;
+	}
+	else
+	{
+		position = rotation(-rotationOffset) * position;
+		vColor = squareColor;
+	}
+
+	gl_Position = vec4(center + position, 0.0, 1.0);
+}
\ No newline at end of file
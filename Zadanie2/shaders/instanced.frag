@@ -0,0 +1,10 @@
+#version 330
+
+in vec4 vColor; // kolor obiektu
+
+out vec4 fColor;
+
+void main()
+{
+    fColor = vColor;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#version 330
+
+layout(location = 0) in vec2 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
+layout(location = 1) in mat3x2 iModelViewMatrix; // macierz model-widok instancji - przeksztalcenie afiniczne 2D (lokalizacje 1-3)
+layout(location = 4) in vec4 iColor; // kolor instancji
+
+out vec4 vColor;
+
+void main()
+{
+	gl_Position = vec4(iModelViewMatrix * vec3(vPosition, 1.0), 0.0, 1.0);
+	vColor = iColor;
+}
\ No newline at end of file
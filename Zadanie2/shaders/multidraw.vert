@@ -0,0 +1,27 @@
+#version 430
+#extension GL_ARB_shader_draw_parameters : require
+
+// dane jednego rysowania - uklad jak TileDraw
+struct TileDraw
+{
+	mat3x2 mvMatrix; // macierz model-widok - przeksztalcenie afiniczne 2D
+	uint color; // kolor RGBA8
+};
+
+// dane wszystkich rysowan, indeksowane numerem rysowania w glMultiDrawArraysIndirect
+layout(std430, binding = 0) readonly buffer DrawData
+{
+	TileDraw draws[];
+};
+
+layout(location = 0) in vec2 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
+
+out vec4 vColor;
+
+void main()
+{
+	TileDraw draw = draws[gl_DrawIDARB];
+
+	gl_Position = vec4(draw.mvMatrix * vec3(vPosition, 1.0), 0.0, 1.0);
+	vColor = unpackUnorm4x8(draw.color);
+}
\ No newline at end of file
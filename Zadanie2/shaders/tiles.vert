@@ -0,0 +1,8 @@
+#version 330
+
+layout(location = 0) in vec2 vCenter; // srodek kafelka
+
+void main()
+{
+	gl_Position = vec4(vCenter, 0.0, 1.0);
+}
\ No newline at end of file
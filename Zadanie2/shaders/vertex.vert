@@ -1,10 +1,10 @@
 #version 330
 
-uniform mat4 modelViewMatrix; // macierz model-widok
+uniform mat3x2 modelViewMatrix; // macierz model-widok (przeksztalcenie afiniczne 2D)
  
-in vec4 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
+layout(location = 0) in vec2 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
  
 void main()
 {
-	gl_Position = modelViewMatrix * vPosition;
+	gl_Position = vec4(modelViewMatrix * vec3(vPosition, 1.0), 0.0, 1.0);
 }
\ No newline at end of file
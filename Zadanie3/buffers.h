@@ -0,0 +1,32 @@
+#ifndef __BUFFERS_H__
+#define __BUFFERS_H__
+
+#include <iostream>
+
+/*------------------------------------------------------------------------------------------
+** funkcja alokuje bufor dowiazany do target i wypelnia go bezposrednio w zmapowanej
+** pamieci (bez posredniej kopii w pamieci programu)
+** target - cel, do ktorego dowiazany jest bufor (np. GL_ARRAY_BUFFER)
+** size - rozmiar bufora w bajtach
+** fill - funkcja wywolywana ze wskaznikiem na zmapowana pamiec bufora
+** zapis powtarzany jest, jesli glUnmapBuffer zglosi utrate zawartosci bufora
+**------------------------------------------------------------------------------------------*/
+template <typename T, typename Fill>
+void fillBuffer(GLenum target, GLsizeiptr size, Fill fill)
+{
+	glBufferData(target, size, nullptr, GL_STATIC_DRAW);
+
+	do
+	{
+		void* data = glMapBufferRange(target, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (data == nullptr)
+		{
+			std::cerr << "Nie mozna zmapowac bufora (" << size << " B)\n";
+			exit(4);
+		}
+
+		fill(static_cast<T*>(data));
+	} while (glUnmapBuffer(target) == GL_FALSE);
+}
+
+#endif /* __BUFFERS_H__ */
@@ -0,0 +1,259 @@
+#include "culling.h"
+#include "perf.h"
+
+#include <iostream>
+#include <numeric>
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza plaszczyzny ostroslupa z iloczynu macierzy projekcji i widoku (punkt
+** jest wewnatrz, gdy -w <= x, y, z <= w we wspolrzednych przyciecia)
+** viewProjection - iloczyn macierzy projekcji i widoku
+**------------------------------------------------------------------------------------------*/
+void Frustum::extract(const glm::mat4& viewProjection)
+{
+	const glm::mat4 rows = glm::transpose(viewProjection);
+
+	planes[0] = rows[3] + rows[0];
+	planes[1] = rows[3] - rows[0];
+	planes[2] = rows[3] + rows[1];
+	planes[3] = rows[3] - rows[1];
+	planes[4] = rows[3] + rows[2];
+	planes[5] = rows[3] - rows[2];
+
+	for (glm::vec4& plane : planes)
+		plane /= glm::length(glm::vec3(plane));
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja testuje sfery z ostroslupem - sfera jest na zewnatrz, gdy jej srodek lezy dalej
+** niz promien za ktorakolwiek plaszczyzna, a wewnatrz, gdy lezy co najmniej promien przed
+** kazda z nich (sfery przy krawedziach ostroslupa moga byc uznane za przecinajace go);
+** pelne rejestry testowane sa jadrem SIMD wybranym przez simdKernels, a reszta po kolei
+** frustum - ostroslup widzenia
+** x, y, z - srodki sfer
+** radius - promienie sfer
+** count - liczba sfer
+** results - wyniki testow (CullResult)
+**------------------------------------------------------------------------------------------*/
+void testSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius, int count, std::uint8_t* results)
+{
+	const SimdKernels* kernels = simdKernels();
+	const int first = kernels ? kernels->testSphereBlocks(&frustum.planes[0].x, x, y, z, radius, count, results) : 0;
+
+	for (int i = first; i < count; i++)
+	{
+		std::uint8_t result = CULL_INSIDE;
+
+		for (const glm::vec4& plane : frustum.planes)
+		{
+			const float distance = plane.x * x[i] + plane.y * y[i] + plane.z * z[i] + plane.w;
+
+			if (distance < -radius[i])
+			{
+				result = CULL_OUTSIDE;
+				break;
+			}
+			if (distance < radius[i])
+				result = CULL_INTERSECT;
+		}
+
+		results[i] = result;
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza widoczne wezly sceny - przedzialy SceneGraph przetwarzane sa po kolei,
+** a w kazdym z nich testowane sa tylko wezly, ktorych rodzic przecina brzeg ostroslupa
+** (pozostale dziedzicza wynik rodzica)
+** scene - hierarchia obiektow z aktualnymi macierzami swiata i sferami poddrzew
+** frustum - ostroslup widzenia
+** meshRadius - promien siatki obiektu przed skalowaniem
+**------------------------------------------------------------------------------------------*/
+void SceneCulling::cull(const SceneGraph& scene, const Frustum& frustum, float meshRadius)
+{
+	Stopwatch stopwatch;
+
+	const int count = scene.size();
+	long long tests = 0;
+
+	states.resize(count);
+	visibleFlags.resize(count);
+
+	for (size_t range = 0; range < scene.rangeStarts.size(); range++)
+	{
+		const int first = scene.rangeStarts[range];
+		const int last = (range + 1 < scene.rangeStarts.size()) ? scene.rangeStarts[range + 1] : count;
+		const int chunks = (last - first + CHUNK - 1) / CHUNK;
+
+		#pragma omp parallel if (chunks > 1) reduction(+ : tests)
+		{
+			std::vector<float> x(CHUNK), y(CHUNK), z(CHUNK), radius(CHUNK);
+			std::vector<int> nodes(CHUNK);
+			std::vector<std::uint8_t> results(CHUNK);
+
+			#pragma omp for
+			for (int chunk = 0; chunk < chunks; chunk++)
+			{
+				const int begin = first + chunk * CHUNK;
+				const int end = glm::min(begin + CHUNK, last);
+
+				// sfery poddrzew wezlow, ktorych rodzic nie jest rozstrzygniety
+				int tested = 0;
+				for (int i = begin; i < end; i++)
+				{
+					const int parent = scene.parents[i];
+					const std::uint8_t parentState = (parent < 0) ? static_cast<std::uint8_t>(CULL_INTERSECT) : states[parent];
+
+					if (parentState != CULL_INTERSECT)
+					{
+						states[i] = parentState;
+						continue;
+					}
+
+					const glm::vec4& center = scene.worldMatrices[i][3];
+					x[tested] = center.x;
+					y[tested] = center.y;
+					z[tested] = center.z;
+					radius[tested] = scene.boundRadii[i];
+					nodes[tested++] = i;
+				}
+
+				testSpheres(frustum, x.data(), y.data(), z.data(), radius.data(), tested, results.data());
+				for (int k = 0; k < tested; k++)
+					states[nodes[k]] = results[k];
+
+				tests += tested;
+
+				// wlasne sfery wezlow, ktorych poddrzewo przecina brzeg ostroslupa i jest wieksze od nich
+				tested = 0;
+				for (int i = begin; i < end; i++)
+				{
+					const float ownRadius = scene.scales[i] * meshRadius;
+					visibleFlags[i] = (states[i] != CULL_OUTSIDE);
+
+					if (states[i] != CULL_INTERSECT || scene.boundRadii[i] <= ownRadius)
+						continue;
+
+					const glm::vec4& center = scene.worldMatrices[i][3];
+					x[tested] = center.x;
+					y[tested] = center.y;
+					z[tested] = center.z;
+					radius[tested] = ownRadius;
+					nodes[tested++] = i;
+				}
+
+				testSpheres(frustum, x.data(), y.data(), z.data(), radius.data(), tested, results.data());
+				for (int k = 0; k < tested; k++)
+					visibleFlags[nodes[k]] = (results[k] != CULL_OUTSIDE);
+
+				tests += tested;
+			}
+		}
+	}
+
+	collectVisible(count);
+
+	testsTotal += tests;
+	cullMs += stopwatch.elapsedMs();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza widoczne ciala symulacji N cial (bez hierarchii - kazde cialo osobno)
+** bodies - polozenia (xyz) cial
+** ids - numery cial (indeksy skal)
+** scales - skale cial
+** count - liczba cial
+** frustum - ostroslup widzenia
+** meshRadius - promien siatki obiektu przed skalowaniem
+**------------------------------------------------------------------------------------------*/
+void SceneCulling::cullBodies(const glm::vec4* bodies, const int* ids, const std::vector<float>& scales, int count, const Frustum& frustum, float meshRadius)
+{
+	Stopwatch stopwatch;
+
+	const int chunks = (count + CHUNK - 1) / CHUNK;
+
+	visibleFlags.resize(count);
+
+	#pragma omp parallel if (chunks > 1)
+	{
+		std::vector<float> x(CHUNK), y(CHUNK), z(CHUNK), radius(CHUNK);
+		std::vector<std::uint8_t> results(CHUNK);
+
+		#pragma omp for
+		for (int chunk = 0; chunk < chunks; chunk++)
+		{
+			const int begin = chunk * CHUNK;
+			const int end = glm::min(begin + CHUNK, count);
+
+			for (int i = begin; i < end; i++)
+			{
+				x[i - begin] = bodies[i].x;
+				y[i - begin] = bodies[i].y;
+				z[i - begin] = bodies[i].z;
+				radius[i - begin] = scales[ids[i]] * meshRadius;
+			}
+
+			testSpheres(frustum, x.data(), y.data(), z.data(), radius.data(), end - begin, results.data());
+			for (int i = begin; i < end; i++)
+				visibleFlags[i] = (results[i - begin] != CULL_OUTSIDE);
+		}
+	}
+
+	collectVisible(count);
+
+	testsTotal += count;
+	cullMs += stopwatch.elapsedMs();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja uznaje wszystkie obiekty za widoczne (odrzucanie wylaczone) - bez zliczania
+** count - liczba obiektow
+**------------------------------------------------------------------------------------------*/
+void SceneCulling::acceptAll(int count)
+{
+	visible.resize(count);
+	std::iota(visible.begin(), visible.end(), 0);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zapisuje indeksy widocznych obiektow i zlicza widoczne i odrzucone obiekty
+** count - liczba obiektow
+**------------------------------------------------------------------------------------------*/
+void SceneCulling::collectVisible(int count)
+{
+	visible.clear();
+	for (int i = 0; i < count; i++)
+	{
+		if (visibleFlags[i])
+			visible.push_back(i);
+	}
+
+	frames++;
+	visibleTotal += visibleCount();
+	culledTotal += count - visibleCount();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zeruje liczniki
+**------------------------------------------------------------------------------------------*/
+void SceneCulling::resetStats()
+{
+	frames = 0;
+	visibleTotal = 0;
+	culledTotal = 0;
+	testsTotal = 0;
+	cullMs = 0.0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyswietla srednia liczbe widocznych i odrzuconych obiektow oraz testow sfer
+** i czas odrzucania na klatke
+** label - opis wyswietlany przed wynikami
+**------------------------------------------------------------------------------------------*/
+void SceneCulling::printStats(const char* label) const
+{
+	const double perFrame = (frames > 0) ? 1.0 / frames : 0.0;
+
+	std::cout << label << " (" << frames << " klatek, srednio na klatke): widoczne " << visibleTotal * perFrame << ", odrzucone "
+		<< culledTotal * perFrame << ", testy sfer (" << simdName() << ") " << testsTotal * perFrame << ", " << cullMs * perFrame << " ms" << std::endl;
+}
@@ -0,0 +1,55 @@
+#ifndef __CULLING_H__
+#define __CULLING_H__
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+#include "scene.h"
+#include "simd.h" // CullResult
+
+/*------------------------------------------------------------------------------------------
+** ostroslup widzenia - szesc plaszczyzn (normalna skierowana do wnetrza, xyz jednostkowe)
+** wyznaczonych z macierzy projekcji i widoku
+**------------------------------------------------------------------------------------------*/
+struct Frustum
+{
+	glm::vec4 planes[6]; // lewa, prawa, dolna, gorna, bliska, daleka
+
+	void extract(const glm::mat4& viewProjection);
+};
+
+void testSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius, int count, std::uint8_t* results);
+
+/*------------------------------------------------------------------------------------------
+** odrzucanie obiektow sceny lezacych poza ostroslupem widzenia - sfery otaczajace poddrzewa
+** (SceneGraph::boundRadii) testowane sa przedzialami od korzeni, wiec poddrzewo calkowicie
+** poza ostroslupem lub w jego wnetrzu rozstrzygane jest jednym testem, a wezly, ktorych
+** poddrzewo przecina brzeg ostroslupa, testowane sa dodatkowo wlasna sfera
+**------------------------------------------------------------------------------------------*/
+struct SceneCulling
+{
+	static const int CHUNK = 4096; // liczba wezlow przedzialu testowanych przez jeden watek
+
+	std::vector<std::uint8_t> states; // wynik testu poddrzewa wezla (CullResult)
+	std::vector<std::uint8_t> visibleFlags; // czy wezel jest widoczny
+	std::vector<int> visible; // widoczne wezly w kolejnosci indeksow
+
+	long long frames = 0; // liczba klatek od resetStats
+	long long visibleTotal = 0; // suma widocznych obiektow
+	long long culledTotal = 0; // suma odrzuconych obiektow
+	long long testsTotal = 0; // suma testow sfer
+	double cullMs = 0.0; // laczny czas odrzucania
+
+	int visibleCount() const { return static_cast<int>(visible.size()); }
+
+	void cull(const SceneGraph& scene, const Frustum& frustum, float meshRadius);
+	void cullBodies(const glm::vec4* bodies, const int* ids, const std::vector<float>& scales, int count, const Frustum& frustum, float meshRadius);
+	void acceptAll(int count);
+	void resetStats();
+	void printStats(const char* label) const;
+	void collectVisible(int count);
+};
+
+#endif /* __CULLING_H__ */
@@ -0,0 +1,304 @@
+#include "gpuculling.h"
+#include "indirect.h"
+#include "shaders.h"
+
+#include <iostream>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzy shader obliczeniowy, bufory polecen, widocznych i zaslonietych obiektow
+** oraz VAO siatek
+** scene - obiekty aktualizowane na GPU (dane obiektow i macierze swiata)
+** lods - LOD_COUNT poziomow szczegolowosci siatki, od najdokladniejszego
+** pixels - LOD_COUNT - 1 progow promienia na ekranie (w pikselach), malejaco
+** vertexBuffer, indexBuffer, edgeBuffer - bufory wierzcholkow, indeksow trojkatow
+**                                         i indeksow krawedzi wszystkich poziomow
+** funkcja zwraca true jesli powiedzie sie tworzenie shadera
+**------------------------------------------------------------------------------------------*/
+bool GpuCulling::init(const GpuSceneUpdate& scene, const MeshLod* lods, const float* pixels, GLuint vertexBuffer, GLuint indexBuffer, GLuint edgeBuffer)
+{
+	if (!setupProgram({ { "shaders/cull.comp", GL_COMPUTE_SHADER } }, program))
+	{
+		program = 0;
+		return false;
+	}
+
+	countLoc = glGetUniformLocation(program, "count");
+	planesLoc = glGetUniformLocation(program, "planes");
+	cameraLoc = glGetUniformLocation(program, "camera");
+	meshRadiusLoc = glGetUniformLocation(program, "meshRadius");
+	lodScaleLoc = glGetUniformLocation(program, "lodScale");
+	lodPixelsLoc = glGetUniformLocation(program, "lodPixels");
+	phaseLoc = glGetUniformLocation(program, "phase");
+	occlusionLoc = glGetUniformLocation(program, "occlusion");
+	viewProjectionLoc = glGetUniformLocation(program, "viewProjection");
+	hiZLevelsLoc = glGetUniformLocation(program, "hiZLevels");
+
+	count = scene.count;
+
+	for (int lod = 0; lod < LOD_COUNT - 1; lod++)
+		lodPixels[lod] = pixels[lod];
+	glProgramUniform1fv(program, lodPixelsLoc, LOD_COUNT - 1, lodPixels);
+
+	// kazdy poziom kazdej fazy ma przedzial count indeksow obiektow zaczynajacy sie od baseInstance
+	const GLsizeiptr commandsSize = PHASE_COUNT * COMMAND_COUNT * sizeof(DrawElementsIndirectCommand);
+
+	std::vector<DrawElementsIndirectCommand> commands(PHASE_COUNT * COMMAND_COUNT);
+	for (int phase = 0; phase < PHASE_COUNT; phase++)
+	{
+		for (int lod = 0; lod < LOD_COUNT; lod++)
+		{
+			const GLuint baseInstance = static_cast<GLuint>((phase * LOD_COUNT + lod) * count);
+			DrawElementsIndirectCommand* phaseCommands = &commands[phase * COMMAND_COUNT];
+
+			phaseCommands[lod] = { lods[lod].indexCount, 0, lods[lod].firstIndex, lods[lod].baseVertex, baseInstance };
+			phaseCommands[LOD_COUNT + lod] = { lods[lod].edgeCount, 0, lods[lod].firstEdge, lods[lod].baseVertex, baseInstance };
+		}
+	}
+
+	const RetestHeader emptyRetest = { { 0, 1, 1 }, 0 };
+
+	glGenBuffers(1, &resetBuffer);
+	glBindBuffer(GL_COPY_READ_BUFFER, resetBuffer);
+	glBufferData(GL_COPY_READ_BUFFER, commandsSize + sizeof(RetestHeader), nullptr, GL_STATIC_COPY);
+	glBufferSubData(GL_COPY_READ_BUFFER, 0, commandsSize, commands.data());
+	glBufferSubData(GL_COPY_READ_BUFFER, commandsSize, sizeof(RetestHeader), &emptyRetest);
+
+	glGenBuffers(1, &commandBuffer);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, commandsSize, commands.data(), GL_DYNAMIC_COPY);
+
+	glGenBuffers(1, &visibleBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(PHASE_COUNT * LOD_COUNT) * count * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+
+	glGenBuffers(1, &retestBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, retestBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(RetestHeader) + static_cast<GLsizeiptr>(count) * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+
+	// statystyki - polecenia obu faz i naglowek obiektow zaslonietych
+	glGenBuffers(STATS_LATENCY, statsBuffers);
+	for (GLuint buffer : statsBuffers)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, commandsSize + sizeof(RetestHeader), nullptr, GL_STREAM_READ);
+	}
+
+	// indeks obiektu jest atrybutem instancji - baseInstance polecenia wybiera przedzial poziomu
+	glGenVertexArrays(2, vertexArrays);
+	for (int i = 0; i < 2; i++)
+	{
+		glBindVertexArray(vertexArrays[i]);
+
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
+
+		glBindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+		glEnableVertexAttribArray(1);
+		glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, 0, 0);
+		glVertexAttribDivisor(1, 1);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, i == 0 ? indexBuffer : edgeBuffer);
+	}
+	glBindVertexArray(0);
+
+	resetStats();
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa shader, bufory i VAO
+**------------------------------------------------------------------------------------------*/
+void GpuCulling::destroy()
+{
+	glDeleteProgram(program);
+	glDeleteBuffers(1, &commandBuffer);
+	glDeleteBuffers(1, &resetBuffer);
+	glDeleteBuffers(1, &visibleBuffer);
+	glDeleteBuffers(1, &retestBuffer);
+	glDeleteBuffers(STATS_LATENCY, statsBuffers);
+	glDeleteVertexArrays(2, vertexArrays);
+
+	program = commandBuffer = resetBuffer = visibleBuffer = retestBuffer = 0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza na GPU widoczne obiekty i ich poziomy szczegolowosci (pierwsza faza);
+** polecenia rysowania i naglowek obiektow zaslonietych zerowane sa kopia resetBuffer,
+** a bariera po odrzucaniu udostepnia polecenia i indeksy obiektow rysowaniu i drugiej
+** fazie (macierze swiata musza byc juz wyznaczone przez scene.update)
+** state - pamiec podreczna stanu OpenGL
+** scene - obiekty aktualizowane na GPU
+** frustum - ostroslup widzenia
+** viewProjection - iloczyn macierzy projekcji i widoku (rzut sfer na piramide Hi-Z)
+** camera - polozenie kamery w ukladzie swiata
+** lodScale - promien w pikselach obiektu o promieniu 1 w odleglosci 1 od kamery
+** meshRadius - promien siatki obiektu przed skalowaniem
+** hiZ - piramida glebokosci poprzedniej klatki (nullptr - bez testu zasloniecia)
+**------------------------------------------------------------------------------------------*/
+void GpuCulling::cull(StateCache& state, const GpuSceneUpdate& scene, const Frustum& frustum, const glm::mat4& viewProjection, const glm::vec3& camera,
+	float lodScale, float meshRadius, const HiZPyramid* hiZ)
+{
+	const GLsizeiptr commandsSize = PHASE_COUNT * COMMAND_COUNT * sizeof(DrawElementsIndirectCommand);
+	const bool occlusion = (hiZ != nullptr && hiZ->valid);
+
+	state.bindBuffer(GL_COPY_READ_BUFFER, resetBuffer);
+	state.bindBuffer(GL_COPY_WRITE_BUFFER, commandBuffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, commandsSize);
+	state.bindBuffer(GL_COPY_WRITE_BUFFER, retestBuffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, commandsSize, 0, sizeof(RetestHeader));
+
+	state.useProgram(program);
+	state.uniform1i(countLoc, count);
+	state.uniform1i(phaseLoc, 0);
+	state.uniform1i(occlusionLoc, occlusion ? 1 : 0);
+	glUniform4fv(planesLoc, 6, &frustum.planes[0].x);
+	glUniformMatrix4fv(viewProjectionLoc, 1, GL_FALSE, &viewProjection[0][0]);
+	glUniform3fv(cameraLoc, 1, &camera.x);
+	glUniform1f(meshRadiusLoc, meshRadius);
+	glUniform1f(lodScaleLoc, lodScale);
+
+	if (occlusion)
+	{
+		state.uniform1i(hiZLevelsLoc, hiZ->levels);
+		glActiveTexture(GL_TEXTURE0 + HIZ_TEXTURE_UNIT);
+		glBindTexture(GL_TEXTURE_2D, hiZ->texture);
+	}
+
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, BODY_DATA_BINDING, scene.bodyBuffer);
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, WORLD_MATRIX_BINDING, scene.worldBuffer);
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_OBJECTS_BINDING, visibleBuffer);
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, CULL_COMMANDS_BINDING, commandBuffer);
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, RETEST_OBJECTS_BINDING, retestBuffer);
+
+	glDispatchCompute((count + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja testuje ponownie obiekty zasloniete w pierwszej fazie (druga faza) - liczbe grup
+** shadera zapisala pierwsza faza w RetestHeader, a widoczne obiekty dopisywane sa do
+** polecen drugiej fazy; piramida musi byc zbudowana z glebokosci obiektow pierwszej fazy
+** state - pamiec podreczna stanu OpenGL
+** scene - obiekty aktualizowane na GPU
+** hiZ - piramida glebokosci biezacej klatki
+**------------------------------------------------------------------------------------------*/
+void GpuCulling::retest(StateCache& state, const GpuSceneUpdate& scene, const HiZPyramid& hiZ)
+{
+	state.useProgram(program);
+	state.uniform1i(phaseLoc, 1);
+	state.uniform1i(occlusionLoc, 1);
+	state.uniform1i(hiZLevelsLoc, hiZ.levels);
+
+	glActiveTexture(GL_TEXTURE0 + HIZ_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D, hiZ.texture);
+
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, BODY_DATA_BINDING, scene.bodyBuffer);
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, WORLD_MATRIX_BINDING, scene.worldBuffer);
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_OBJECTS_BINDING, visibleBuffer);
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, CULL_COMMANDS_BINDING, commandBuffer);
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, RETEST_OBJECTS_BINDING, retestBuffer);
+
+	state.bindBuffer(GL_DISPATCH_INDIRECT_BUFFER, retestBuffer);
+	glDispatchComputeIndirect(0);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja kopiuje polecenia i naglowek obiektow zaslonietych biezacej klatki do bufora
+** statystyk, a nastepnie odczytuje statystyki klatki sprzed STATS_LATENCY klatek (bufor,
+** ktory zostanie zapisany w nastepnej klatce) i dodaje je do licznikow
+** state - pamiec podreczna stanu OpenGL
+**------------------------------------------------------------------------------------------*/
+void GpuCulling::collectStats(StateCache& state)
+{
+	const GLsizeiptr commandsSize = PHASE_COUNT * COMMAND_COUNT * sizeof(DrawElementsIndirectCommand);
+
+	state.bindBuffer(GL_COPY_WRITE_BUFFER, statsBuffers[frames % STATS_LATENCY]);
+	state.bindBuffer(GL_COPY_READ_BUFFER, commandBuffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, commandsSize);
+	state.bindBuffer(GL_COPY_READ_BUFFER, retestBuffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, commandsSize, sizeof(RetestHeader));
+
+	frames++;
+
+	if (frames - statsFrames < STATS_LATENCY)
+		return;
+	if (frames - statsFrames > STATS_LATENCY) // starsze bufory zostaly juz zapisane ponownie
+		statsFrames = frames - STATS_LATENCY;
+
+	DrawElementsIndirectCommand commands[PHASE_COUNT * COMMAND_COUNT];
+	RetestHeader retested;
+
+	state.bindBuffer(GL_COPY_READ_BUFFER, statsBuffers[statsFrames % STATS_LATENCY]);
+	glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(commands), commands);
+	glGetBufferSubData(GL_COPY_READ_BUFFER, sizeof(commands), sizeof(retested), &retested);
+
+	GLuint recovered = 0;
+	for (int lod = 0; lod < LOD_COUNT; lod++)
+	{
+		recovered += commands[COMMAND_COUNT + lod].instanceCount;
+
+		lastCounts[lod] = commands[lod].instanceCount + commands[COMMAND_COUNT + lod].instanceCount;
+		lodTotals[lod] += lastCounts[lod];
+	}
+
+	lastOccluded = retested.count - recovered;
+	occludedTotal += lastOccluded;
+	recoveredTotal += recovered;
+
+	statsFrames++;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca liczbe widocznych obiektow ostatniej odczytanej klatki
+**------------------------------------------------------------------------------------------*/
+int GpuCulling::lastVisible() const
+{
+	int visible = 0;
+	for (GLuint lodCount : lastCounts)
+		visible += static_cast<int>(lodCount);
+
+	return visible;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zeruje liczniki (klatki w drodze do bufora statystyk nie sa juz zliczane)
+**------------------------------------------------------------------------------------------*/
+void GpuCulling::resetStats()
+{
+	frames = 0;
+	statsFrames = 0;
+
+	for (int lod = 0; lod < LOD_COUNT; lod++)
+	{
+		lodTotals[lod] = 0;
+		lastCounts[lod] = 0;
+	}
+
+	occludedTotal = 0;
+	recoveredTotal = 0;
+	lastOccluded = 0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyswietla srednia liczbe widocznych obiektow kolejnych poziomow szczegolowosci,
+** obiektow poza ostroslupem i zaslonietych oraz obiektow widocznych dopiero w drugiej fazie
+** na klatke
+** label - opis wyswietlany przed wynikami
+**------------------------------------------------------------------------------------------*/
+void GpuCulling::printStats(const char* label) const
+{
+	const double perFrame = (statsFrames > 0) ? 1.0 / statsFrames : 0.0;
+
+	long long visibleTotal = 0;
+	for (long long lodTotal : lodTotals)
+		visibleTotal += lodTotal;
+
+	std::cout << label << " (" << statsFrames << " klatek, srednio na klatke): widoczne " << visibleTotal * perFrame << " (poziomy szczegolowosci";
+	for (long long lodTotal : lodTotals)
+		std::cout << " " << lodTotal * perFrame;
+	std::cout << "), poza ostroslupem " << count - (visibleTotal + occludedTotal) * perFrame << ", zasloniete " << occludedTotal * perFrame
+		<< ", widoczne dopiero w drugiej fazie " << recoveredTotal * perFrame << std::endl;
+}
@@ -0,0 +1,101 @@
+#ifndef __GPUCULLING_H__
+#define __GPUCULLING_H__
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "culling.h"
+#include "gpuupdate.h"
+#include "hiz.h"
+#include "statecache.h"
+
+const GLuint VISIBLE_OBJECTS_BINDING = 3; // punkt wiazania SSBO z indeksami widocznych obiektow
+const GLuint CULL_COMMANDS_BINDING = 4; // punkt wiazania SSBO z poleceniami rysowania posredniego poziomow szczegolowosci
+const GLuint RETEST_OBJECTS_BINDING = 5; // punkt wiazania SSBO z obiektami zaslonietymi w pierwszej fazie
+
+// naglowek bufora obiektow do ponownego testu - argumenty glDispatchComputeIndirect i liczba obiektow
+struct RetestHeader
+{
+	GLuint groups[3];
+	GLuint count;
+};
+
+/*------------------------------------------------------------------------------------------
+** poziom szczegolowosci siatki - fragmenty wspolnych buforow wierzcholkow, indeksow
+** trojkatow i indeksow krawedzi
+**------------------------------------------------------------------------------------------*/
+struct MeshLod
+{
+	GLuint indexCount; // liczba indeksow trojkatow
+	GLuint firstIndex; // pierwszy indeks trojkatow w buforze indeksow
+	GLuint edgeCount; // liczba indeksow krawedzi
+	GLuint firstEdge; // pierwszy indeks krawedzi w buforze krawedzi
+	GLint baseVertex; // pierwszy wierzcholek siatki w buforze wierzcholkow
+};
+
+/*------------------------------------------------------------------------------------------
+** odrzucanie obiektow i wybor poziomu szczegolowosci na GPU - shader obliczeniowy testuje
+** sfere kazdego obiektu (macierze swiata z GpuSceneUpdate) z ostroslupem widzenia, wybiera
+** poziom szczegolowosci wedlug promienia obiektu na ekranie i dopisuje indeks obiektu do
+** przedzialu poziomu w visibleBuffer, zwiekszajac instanceCount jego polecen rysowania;
+** polecenia (LOD_COUNT dla trojkatow, a nastepnie LOD_COUNT dla krawedzi) wykonywane sa
+** jednym glMultiDrawElementsIndirect, wiec CPU nie czyta ani nie zapisuje danych obiektow
+** przy odrzucaniu zaslonietych obiektow (piramida Hi-Z) odrzucanie przebiega w dwoch fazach:
+** pierwsza testuje obiekty z piramida poprzedniej klatki, a zasloniete zapisuje w
+** retestBuffer; po narysowaniu obiektow pierwszej fazy piramida budowana jest z biezacego
+** bufora glebokosci, a druga faza (glDispatchComputeIndirect) testuje z nia ponownie
+** zasloniete obiekty i rysuje te, ktore sa jednak widoczne - polecenia i indeksy drugiej
+** fazy zajmuja osobne przedzialy (PHASE_COUNT * LOD_COUNT przedzialow po count elementow)
+** liczby widocznych obiektow kopiowane sa do buforow statystyk i odczytywane z opoznieniem
+** STATS_LATENCY klatek, aby odczyt nie czekal na GPU
+**------------------------------------------------------------------------------------------*/
+struct GpuCulling
+{
+	static const int GROUP_SIZE = 256; // local_size_x w cull.comp
+	static const int LOD_COUNT = 3; // liczba poziomow szczegolowosci (jak w cull.comp)
+	static const int PHASE_COUNT = 2; // fazy odrzucania (z piramida poprzedniej i biezacej klatki)
+	static const int COMMAND_COUNT = 2 * LOD_COUNT; // polecenia jednej fazy (trojkaty, a nastepnie krawedzie)
+	static const int STATS_LATENCY = 3; // liczba buforow statystyk (opoznienie odczytu w klatkach)
+
+	GLuint program = 0; // shader obliczeniowy (0 - brak OpenGL 4.3)
+	GLuint commandBuffer = 0; // polecenia rysowania biezacej klatki (COMMAND_COUNT polecen kazdej fazy)
+	GLuint resetBuffer = 0; // polecenia z instanceCount = 0 i pusty RetestHeader, kopiowane przed odrzucaniem
+	GLuint visibleBuffer = 0; // indeksy widocznych obiektow - PHASE_COUNT * LOD_COUNT przedzialow po count elementow
+	GLuint retestBuffer = 0; // RetestHeader i indeksy obiektow zaslonietych w pierwszej fazie
+	GLuint vertexArrays[2] = {}; // VAO siatek z indeksem obiektu jako atrybutem instancji (trojkaty, krawedzie)
+	GLuint statsBuffers[STATS_LATENCY] = {};
+
+	GLint countLoc = -1;
+	GLint planesLoc = -1;
+	GLint cameraLoc = -1;
+	GLint meshRadiusLoc = -1;
+	GLint lodScaleLoc = -1;
+	GLint lodPixelsLoc = -1;
+	GLint phaseLoc = -1;
+	GLint occlusionLoc = -1;
+	GLint viewProjectionLoc = -1;
+	GLint hiZLevelsLoc = -1;
+
+	int count = 0; // liczba obiektow
+	float lodPixels[LOD_COUNT - 1] = {}; // promien na ekranie (w pikselach), ponizej ktorego wybierany jest kolejny poziom
+
+	long long frames = 0; // liczba klatek od resetStats
+	long long statsFrames = 0; // liczba klatek, ktorych statystyki odczytano
+	long long lodTotals[LOD_COUNT] = {}; // suma widocznych obiektow kolejnych poziomow
+	long long occludedTotal = 0; // suma obiektow odrzuconych jako zasloniete
+	long long recoveredTotal = 0; // suma obiektow zaslonietych w pierwszej fazie i widocznych w drugiej
+	GLuint lastCounts[LOD_COUNT] = {}; // widoczne obiekty kolejnych poziomow w ostatniej odczytanej klatce
+	GLuint lastOccluded = 0; // obiekty zasloniete w ostatniej odczytanej klatce
+
+	bool init(const GpuSceneUpdate& scene, const MeshLod* lods, const float* pixels, GLuint vertexBuffer, GLuint indexBuffer, GLuint edgeBuffer);
+	void destroy();
+	void cull(StateCache& state, const GpuSceneUpdate& scene, const Frustum& frustum, const glm::mat4& viewProjection, const glm::vec3& camera,
+		float lodScale, float meshRadius, const HiZPyramid* hiZ);
+	void retest(StateCache& state, const GpuSceneUpdate& scene, const HiZPyramid& hiZ);
+	void collectStats(StateCache& state);
+	int lastVisible() const;
+	void resetStats();
+	void printStats(const char* label) const;
+};
+
+#endif /* __GPUCULLING_H__ */
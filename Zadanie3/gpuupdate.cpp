@@ -0,0 +1,77 @@
+#include "gpuupdate.h"
+#include "shaders.h"
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzy shader obliczeniowy oraz bufory z danymi obiektow sceny
+** scene - hierarchia obiektow (wezly uporzadkowane przedzialami)
+** colors - kolory obiektow
+** funkcja zwraca true jesli powiedzie sie tworzenie shadera
+**------------------------------------------------------------------------------------------*/
+bool GpuSceneUpdate::init(const SceneGraph& scene, const std::vector<glm::u8vec4>& colors)
+{
+	if (!setupProgram({ { "shaders/transforms.comp", GL_COMPUTE_SHADER } }, program))
+	{
+		program = 0;
+		return false;
+	}
+
+	firstLoc = glGetUniformLocation(program, "first");
+	countLoc = glGetUniformLocation(program, "count");
+	timeLoc = glGetUniformLocation(program, "time");
+
+	count = scene.size();
+	rangeStarts = scene.rangeStarts;
+
+	std::vector<GpuBody> bodies(count);
+	for (int i = 0; i < count; i++)
+		bodies[i] = { scene.orbits[i], scene.parents[i], scene.scales[i], colors[i] };
+
+	glGenBuffers(1, &bodyBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, bodyBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(GpuBody), bodies.data(), GL_STATIC_DRAW);
+
+	glGenBuffers(1, &worldBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, worldBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(glm::mat4), nullptr, GL_DYNAMIC_COPY);
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa shader i bufory
+**------------------------------------------------------------------------------------------*/
+void GpuSceneUpdate::destroy()
+{
+	glDeleteProgram(program);
+	glDeleteBuffers(1, &bodyBuffer);
+	glDeleteBuffers(1, &worldBuffer);
+
+	program = bodyBuffer = worldBuffer = 0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza na GPU macierze swiata wszystkich obiektow w chwili t; bariera po
+** kazdym przedziale udostepnia jego wyniki kolejnemu przedzialowi i rysowaniu
+** state - pamiec podreczna stanu OpenGL
+** t - czas symulacji w sekundach
+**------------------------------------------------------------------------------------------*/
+void GpuSceneUpdate::update(StateCache& state, double t) const
+{
+	state.useProgram(program);
+	glUniform1d(timeLoc, t);
+
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, BODY_DATA_BINDING, bodyBuffer);
+	state.bindBufferBase(GL_SHADER_STORAGE_BUFFER, WORLD_MATRIX_BINDING, worldBuffer);
+
+	for (size_t range = 0; range < rangeStarts.size(); range++)
+	{
+		const int first = rangeStarts[range];
+		const int last = (range + 1 < rangeStarts.size()) ? rangeStarts[range + 1] : count;
+
+		state.uniform1i(firstLoc, first);
+		state.uniform1i(countLoc, last - first);
+
+		glDispatchCompute((last - first + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+}
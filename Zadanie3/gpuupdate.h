@@ -0,0 +1,63 @@
+#ifndef __GPUUPDATE_H__
+#define __GPUUPDATE_H__
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
+
+#include <vector>
+
+#include "orbit.h"
+#include "scene.h"
+#include "statecache.h"
+
+const GLuint BODY_DATA_BINDING = 1; // punkt wiazania SSBO z danymi obiektow (orbity, hierarchia, skala, kolor)
+const GLuint WORLD_MATRIX_BINDING = 2; // punkt wiazania SSBO z macierzami swiata obiektow
+
+/*------------------------------------------------------------------------------------------
+** dane obiektu w SSBO - uklad std430 struktury Body w transforms.comp i instancedgpu.vert
+**------------------------------------------------------------------------------------------*/
+struct GpuBody
+{
+	Orbit orbit;
+	GLint parent; // indeks rodzica (-1 - korzen)
+	float scale;
+	glm::u8vec4 color;
+};
+
+/*------------------------------------------------------------------------------------------
+** aktualizacja hierarchii obiektow na GPU - orbity, hierarchia i macierze swiata obiektow
+** przechowywane sa w SSBO, a shader obliczeniowy wyznacza co klatke macierze swiata
+** kolejnych przedzialow SceneGraph (po jednym wywolaniu glDispatchCompute na przedzial,
+** bo dzieci czytaja macierze rodzicow z poprzedniego przedzialu); shader wierzcholkow
+** czyta wyniki bezposrednio z SSBO, wiec dane nie wracaja do CPU
+**------------------------------------------------------------------------------------------*/
+struct GpuSceneUpdate
+{
+	static const int GROUP_SIZE = 256; // local_size_x w transforms.comp
+
+	GLuint program = 0; // shader obliczeniowy (0 - brak OpenGL 4.3)
+	GLuint bodyBuffer = 0;
+	GLuint worldBuffer = 0;
+
+	GLint firstLoc = -1;
+	GLint countLoc = -1;
+	GLint timeLoc = -1;
+
+	std::vector<int> rangeStarts; // poczatki przedzialow wezlow (jak w SceneGraph)
+	int count = 0; // liczba obiektow
+
+	bool init(const SceneGraph& scene, const std::vector<glm::u8vec4>& colors);
+	void destroy();
+	void update(StateCache& state, double t) const;
+};
+
+/*------------------------------------------------------------------------------------------
+** funkcja sprawdza, czy dostepne sa shadery obliczeniowe, SSBO i zmienne double w GLSL
+**------------------------------------------------------------------------------------------*/
+inline bool computeSupported()
+{
+	return GLEW_VERSION_4_3;
+}
+
+#endif /* __GPUUPDATE_H__ */
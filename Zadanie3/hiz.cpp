@@ -0,0 +1,100 @@
+#include "hiz.h"
+#include "shaders.h"
+
+#include <algorithm>
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzy shader obliczeniowy budujacy piramide (tekstury tworzone sa przy
+** pierwszym wywolaniu build)
+** funkcja zwraca true jesli powiedzie sie tworzenie shadera
+**------------------------------------------------------------------------------------------*/
+bool HiZPyramid::init()
+{
+	if (!setupProgram({ { "shaders/hiz.comp", GL_COMPUTE_SHADER } }, program))
+	{
+		program = 0;
+		return false;
+	}
+
+	levelLoc = glGetUniformLocation(program, "level");
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa shader i tekstury
+**------------------------------------------------------------------------------------------*/
+void HiZPyramid::destroy()
+{
+	glDeleteProgram(program);
+	glDeleteTextures(1, &depthTexture);
+	glDeleteTextures(1, &texture);
+
+	program = depthTexture = texture = 0;
+	width = height = levels = 0;
+	valid = false;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzy tekstury dla bufora ramki o podanym rozmiarze
+** newWidth, newHeight - rozmiar bufora ramki w pikselach
+**------------------------------------------------------------------------------------------*/
+void HiZPyramid::resize(int newWidth, int newHeight)
+{
+	glDeleteTextures(1, &depthTexture);
+	glDeleteTextures(1, &texture);
+
+	width = newWidth;
+	height = newHeight;
+
+	levels = 1;
+	while ((std::max(width, height) >> levels) > 0)
+		levels++;
+
+	glGenTextures(1, &depthTexture);
+	glBindTexture(GL_TEXTURE_2D, depthTexture);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT32F, width, height);
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexStorage2D(GL_TEXTURE_2D, levels, GL_R32F, width, height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	valid = false;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja buduje piramide z bufora glebokosci biezacego bufora ramki; bariera po kazdym
+** poziomie udostepnia go kolejnemu poziomowi, a po ostatnim - testom w cull.comp
+** state - pamiec podreczna stanu OpenGL
+** frameWidth, frameHeight - rozmiar bufora ramki w pikselach
+**------------------------------------------------------------------------------------------*/
+void HiZPyramid::build(StateCache& state, int frameWidth, int frameHeight)
+{
+	if (frameWidth != width || frameHeight != height)
+		resize(frameWidth, frameHeight);
+
+	glActiveTexture(GL_TEXTURE0 + HIZ_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D, depthTexture);
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+
+	state.useProgram(program);
+
+	for (int level = 0; level < levels; level++)
+	{
+		const int levelWidth = std::max(1, width >> level);
+		const int levelHeight = std::max(1, height >> level);
+
+		// poziom 0 czytany jest z kopii bufora glebokosci (jednostka tekstury), kolejne - z poprzedniego poziomu
+		if (level > 0)
+			glBindImageTexture(0, texture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+		glBindImageTexture(1, texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+		state.uniform1i(levelLoc, level);
+
+		glDispatchCompute((levelWidth + GROUP_SIZE - 1) / GROUP_SIZE, (levelHeight + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+	}
+
+	valid = true;
+}
@@ -0,0 +1,38 @@
+#ifndef __HIZ_H__
+#define __HIZ_H__
+
+#include <GL/glew.h>
+
+#include "statecache.h"
+
+const GLuint HIZ_TEXTURE_UNIT = 0; // jednostka tekstury piramidy glebokosci w cull.comp
+
+/*------------------------------------------------------------------------------------------
+** hierarchiczna piramida glebokosci (Hi-Z) - glebokosc biezacego bufora ramki kopiowana
+** jest do tekstury, a shader obliczeniowy zapisuje ja na poziomie 0 tekstury R32F
+** i kolejno wyznacza mniejsze poziomy mipmap jako maksimum glebokosci 2x2 (przy
+** nieparzystym rozmiarze 3x3) tekseli poprzedniego poziomu, wiec teksel poziomu l
+** zawiera najdalsza glebokosc kwadratu 2^l x 2^l pikseli
+**------------------------------------------------------------------------------------------*/
+struct HiZPyramid
+{
+	static const int GROUP_SIZE = 8; // local_size_x i local_size_y w hiz.comp
+
+	GLuint program = 0; // shader obliczeniowy (0 - brak OpenGL 4.3)
+	GLuint depthTexture = 0; // kopia bufora glebokosci (GL_DEPTH_COMPONENT32F)
+	GLuint texture = 0; // piramida (GL_R32F z mipmapami)
+
+	GLint levelLoc = -1;
+
+	int width = 0; // rozmiar poziomu 0 (rozmiar bufora ramki)
+	int height = 0;
+	int levels = 0; // liczba poziomow
+	bool valid = false; // czy piramida zawiera glebokosc poprzedniej klatki
+
+	bool init();
+	void destroy();
+	void resize(int newWidth, int newHeight);
+	void build(StateCache& state, int frameWidth, int frameHeight);
+};
+
+#endif /* __HIZ_H__ */
@@ -7,18 +7,47 @@
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 #include <glm/ext/matrix_transform.hpp>
+#include <glm/gtc/type_precision.hpp>
 
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <random>
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
 
 #include "shaders.h"
-
-
+#include "mesh.h"
+#include "buffers.h"
+#include "perf.h"
+#include "uniforms.h"
+#include "indirect.h"
+#include "statecache.h"
+#include "renderqueue.h"
+#include "simclock.h"
+#include "orbit.h"
+#include "scene.h"
+#include "simd.h"
+#include "gpuupdate.h"
+#include "nbody.h"
+#include "culling.h"
+#include "gpuculling.h"
+
+
+const int PARENT[] = { -1, 0, 1 }; // obiekt, wzgledem ktorego porusza sie dany obiekt (-1 - brak)
 const float SCALE[] = { 0.3f, 0.1f, 0.01f };
-const float OFFSET[] = { 0.0f, 1.5f, 0.2f };
-const float ROT_RATE[] = { 0.0f, 0.3f, -5.0f };
-float rotation[] = { 0.0f, 0.0f, 0.0f };
+
+// orbity obiektow wzgledem obiektu nadrzednego (polos wielka, mimosrod, ruch sredni,
+// anomalia srednia w chwili 0, argument perycentrum); uklad obiektu obraca sie razem z nim
+const Orbit ORBITS[] = {
+	{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+	{ 1.5f, 0.0f, glm::radians(18.0f), 0.0f, 0.0f },
+	{ 0.2f, 0.0f, glm::radians(-300.0f), 0.0f, 0.0f }
+};
 
 const float COLOR[3][4] = {
 	{ 1.0f, 1.0f, 0.0f, 1.0f },
@@ -26,8 +55,6 @@ const float COLOR[3][4] = {
 	{ 1.0f, 1.0f, 1.0f, 1.0f }
 };
 
-glm::mat4 tempMat;
-
 
 const int V_MAX = 12;
 const int U_MAX = 16;
@@ -35,56 +62,178 @@ const int U_MAX = 16;
 const float RADIUS = 1.0f;
 const float Z_MIN = -1.0f;
 const float Z_MAX = 1.0f;
-const float THETA_MAX = 360.0f * ((float)M_PI / 180);
+
+const Sphere SPHERE = { RADIUS, Z_MIN, Z_MAX };
+
+// podzialy siatek kolejnych poziomow szczegolowosci (poziom 0 - siatka obiektow sceny)
+const int LOD_V_MAX[GpuCulling::LOD_COUNT] = { V_MAX, 8, 4 };
+const int LOD_U_MAX[GpuCulling::LOD_COUNT] = { U_MAX, 10, 6 };
+const float LOD_PIXELS[GpuCulling::LOD_COUNT - 1] = { 16.0f, 4.0f }; // promien obiektu na ekranie (w pikselach), ponizej ktorego wybierany jest kolejny poziom
+
+const int SYSTEM_LIMIT = 1000000; // maksymalna liczba obiektow generowanego ukladu planetarnego
+const float GALAXY_RADIUS = 1.5f; // promien kola, w ktorym rozmieszczane sa gwiazdy ukladu
+const float PLANET_MASS = 1e-3f; // masa planety wzgledem masy gwiazdy (--nbody)
+const float MOON_MASS = 1e-6f; // masa ksiezyca wzgledem masy gwiazdy (--nbody)
+
+// sposoby rysowania siatki przelaczane klawiszem F2
+enum WireframeMode { WIREFRAME_POLYGON, WIREFRAME_EDGES, WIREFRAME_BARYCENTRIC, WIREFRAME_MODES };
+
+// dane instancji obiektu ukladu planetarnego - atrybuty 1-5 w instanced.vert
+struct BodyInstance
+{
+	glm::mat4x3 modelMatrix; // macierz modelu bez ostatniego wiersza (0, 0, 0, 1)
+	glm::u8vec4 color;
+};
 
 
 constexpr int WIDTH = 600; // szerokosc okna
 constexpr int HEIGHT = 600; // wysokosc okna
 constexpr float ROT_STEP = 15.0f; // kat obrotu (w stopniach)
 constexpr float ZOOM_FACTOR = 1.1f; // wspolczynnik do zmiany kata fovy
+constexpr double SEEK_STEP = 1.0; // przesuniecie czasu symulacji klawiszami strzalek (w sekundach)
+constexpr int NBODY_MAX_STEPS = 4; // maksymalna liczba krokow symulacji N cial na klatke (wolniejsza symulacja zwalnia zamiast wstrzymywac rysowanie)
+constexpr int BENCHMARK_FRAMES = 100; // liczba klatek mierzonych dla kazdego wariantu w trybie --benchmark
 
 //******************************************************************************************
-GLuint vao; // identyfikatory VAO
-GLuint buffers[2]; // identyfikatory VBO
+GLuint vao[2]; // identyfikatory VAO (trojkaty, krawedzie)
+GLuint buffers[3]; // identyfikatory VBO (wierzcholki, indeksy trojkatow, indeksy krawedzi)
 
 GLuint shaderProgram; // identyfikator programu cieniowania
+GLuint wireframeProgram; // identyfikator programu cieniowania rysujacego wypelnienie z krawedziami w jednym przebiegu
+GLuint multiDrawProgram; // identyfikator programu cieniowania dla glMultiDrawElementsIndirect (dane obiektow z SSBO)
+
+GLuint indirectBuffer; // polecenia rysowania posredniego (po jednym na obiekt dla trojkatow, a nastepnie dla krawedzi)
+RingBuffer drawData; // dane obiektow kolejnych klatek dla multiDrawProgram (SSBO)
+
+GLuint instancedProgram; // identyfikator programu cieniowania ukladu planetarnego (dane obiektow jako atrybuty instancji)
+GLuint instanceVao[2]; // VAO ukladu planetarnego z atrybutami instancji (trojkaty, krawedzie)
+RingBuffer instanceData; // dane instancji kolejnych klatek (macierze modelu i kolory obiektow)
+GLuint instancedGpuProgram; // identyfikator programu cieniowania ukladu planetarnego (dane obiektow z SSBO wypelnianych przez gpuScene)
+GpuSceneUpdate gpuScene; // aktualizacja ukladu planetarnego shaderem obliczeniowym
+GLuint instancedCullProgram; // identyfikator programu cieniowania ukladu planetarnego (obiekty wybrane przez gpuCulling)
+GpuCulling gpuCulling; // odrzucanie obiektow i wybor poziomu szczegolowosci shaderem obliczeniowym (aktualizacja na GPU)
+MeshLod meshLods[GpuCulling::LOD_COUNT]; // poziomy szczegolowosci siatki w buforach buffers
+HiZPyramid hiZ; // piramida glebokosci do odrzucania zaslonietych obiektow przez gpuCulling
+NBodySimulation simulation; // symulacja grawitacji ukladu planetarnego (--nbody)
+SceneCulling culling; // odrzucanie obiektow poza ostroslupem widzenia
 
 GLuint vertexLoc; // lokalizacja atrybutu wierzcholka - wspolrzedne wierzcholkow
-GLuint colorLoc; // lokalizacja zmiennej jednorodnej - kolor rysowania prymitywu
 
-GLuint projMatrixLoc; // lokalizacja zmiennej jednorodnej - macierz projekcji
-GLuint mvMatrixLoc; // lokalizacja zmiennej jednorodnej - macierz model-widok
+UniformBlocks uniformBlocks; // bufory UBO z danymi klatki (FrameBlock) i obiektow (ObjectBlock)
+bool frameChanged = true; // czy dane klatki trzeba zapisac ponownie do UBO
+SceneGraph scene; // hierarchia obiektow sceny
+std::vector<glm::vec4> objectColors; // kolory obiektow sceny
+std::vector<ObjectBlock> objects; // dane obiektow biezacej klatki
+std::vector<glm::u8vec4> packedColors; // kolory obiektow ukladu planetarnego (RGBA8, jak w BodyInstance)
+
+StateCache glState; // pamiec podreczna stanu OpenGL - pomija wywolania, ktore nic nie zmieniaja
+RenderQueue renderQueue; // kolejka rysowania sortowana wedlug stanu
 
 glm::mat4 projMatrix; // macierz projekcji
+glm::mat4 viewMatrix; // macierz widoku
 glm::mat4 mvMatrix; // macierz model-widok
 
 bool wireframe = true; // czy rysowac siatke (true) czy wypelnienie (false)
+WireframeMode wireframeMode = WIREFRAME_POLYGON; // sposob rysowania siatki
 glm::vec3 rotationAngles = glm::vec3(90.0, 0.0, 0.0); // katy rotacji wokol poszczegolnych osi
 float fovy = 25.0f; // kat patrzenia (uzywany do skalowania sceny)
 float aspectRatio = static_cast<float>(WIDTH) / HEIGHT;
+int viewportWidth = WIDTH; // szerokosc obszaru rysowania w pikselach (piramida glebokosci)
+int viewportHeight = HEIGHT; // wysokosc obszaru rysowania w pikselach (wybor poziomu szczegolowosci, piramida glebokosci)
 
 GLint indicesNumber = 0; // liczba indeksow definiujacych obiekt
+GLint edgesNumber = 0; // liczba indeksow krawedzi
 
 float lineWidth = 1.0f; // grubosc linii
+float fillFactor = 0.25f; // jasnosc wypelnienia pod siatka wzgledem koloru obiektu (WIREFRAME_BARYCENTRIC)
+
+bool persistentMapping = true; // czy uzywac trwale zmapowanego bufora danych obiektow (--no-persistent wylacza)
+bool multiDraw = true; // czy rysowac wszystkie obiekty jednym glMultiDrawElementsIndirect (--no-multidraw wylacza)
+bool benchmark = false; // czy uruchomic pomiar wydajnosci sposobow rysowania siatki i zakonczyc program (--benchmark)
+bool nbodyMode = false; // czy uklad planetarny porusza sie pod wplywem grawitacji zamiast po orbitach (--nbody)
+bool frustumCulling = true; // czy pomijac obiekty poza ostroslupem widzenia (--no-culling wylacza, przelaczane klawiszem F4)
+bool occlusionCulling = true; // czy pomijac obiekty zasloniete (aktualizacja na GPU i wypelnienie; --no-occlusion wylacza, przelaczane klawiszem F5)
+bool gpuUpdate = false; // czy wyznaczac macierze swiata ukladu planetarnego na GPU (--gpu-update, przelaczane klawiszem F3)
+
+int systemStars = 0; // liczba gwiazd generowanego ukladu planetarnego (--stars; 0 - scena trzech obiektow)
+int systemPlanets = 8; // liczba planet kazdej gwiazdy (--planets)
+int systemMoons = 4; // liczba ksiezycow kazdej planety (--moons)
+double updateMs = 0.0; // laczny czas aktualizacji obiektow sceny na CPU (zerowany przez runBenchmark)
+
+SimulationClock simClock; // zegar symulacji ze stalym krokiem (w trybie --benchmark wirtualny)
+GpuTimer gpuTimer; // pomiar czasu rysowania na GPU
 //******************************************************************************************
 
 void errorCallback(int error, const char* description);
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 void framebufferSizeCallback(GLFWwindow* window, int width, int height);
 void updateProjectionMatrix();
+void updateViewMatrix();
 void onShutdown();
 void initGL();
+void setupScene();
+void generateSystem();
+void setupNBody();
 void setupShaders();
 void setupBuffers();
 void renderScene();
-
-void generateSphereVertices(std::vector<float> &vertices);
-void generateSphereIndices(std::vector<unsigned int> &vertices);
+void renderMultiDraw(const ObjectBlock* objects, int count, bool edges);
+void renderInstanced(bool edges);
+void renderInstancedGpu(bool edges, bool occlusion);
+void updateWindowTitle(GLFWwindow* window);
+void runBenchmark(GLFWwindow* window);
+void runOcclusionBenchmark(GLFWwindow* window);
+void runTransformBenchmark();
+void parseIntOption(const char* name, const char* text, int minValue, int maxValue, int& value);
 
 int main(int argc, char* argv[])
 {
 	atexit(onShutdown);
 
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--no-persistent")
+			persistentMapping = false;
+		else if (std::string(argv[i]) == "--no-multidraw")
+			multiDraw = false;
+		else if (std::string(argv[i]) == "--benchmark")
+			benchmark = true;
+		else if (std::string(argv[i]) == "--gpu-update")
+			gpuUpdate = true;
+		else if (std::string(argv[i]) == "--nbody")
+			nbodyMode = true;
+		else if (std::string(argv[i]) == "--no-culling")
+			frustumCulling = false;
+		else if (std::string(argv[i]) == "--no-occlusion")
+			occlusionCulling = false;
+		else if (std::string(argv[i]) == "--stars" && i + 1 < argc)
+			parseIntOption("--stars", argv[++i], 0, SYSTEM_LIMIT, systemStars);
+		else if (std::string(argv[i]) == "--planets" && i + 1 < argc)
+			parseIntOption("--planets", argv[++i], 0, SYSTEM_LIMIT, systemPlanets);
+		else if (std::string(argv[i]) == "--moons" && i + 1 < argc)
+			parseIntOption("--moons", argv[++i], 0, SYSTEM_LIMIT, systemMoons);
+	}
+
+	// liczby ograniczone do SYSTEM_LIMIT, wiec ponizszy iloczyn (najwyzej ok. 1e18) miesci sie w long long
+	// zbyt duzy uklad planetarny zmniejszany jest o ksiezyce, a w razie potrzeby o planety
+	if (systemStars * (1 + systemPlanets * (1 + static_cast<long long>(systemMoons))) > SYSTEM_LIMIT)
+	{
+		systemStars = glm::min(systemStars, SYSTEM_LIMIT);
+
+		const int perStar = SYSTEM_LIMIT / systemStars; // limit obiektow na gwiazde (wraz z nia)
+		systemPlanets = glm::min(systemPlanets, perStar - 1);
+		systemMoons = (systemPlanets > 0) ? glm::min(systemMoons, (perStar - 1) / systemPlanets - 1) : 0;
+
+		std::cout << "Limit " << SYSTEM_LIMIT << " obiektow - uklad: " << systemStars << " gwiazd, " << systemPlanets << " planet, "
+			<< systemMoons << " ksiezycow\n";
+	}
+
+	if (nbodyMode && systemStars == 0)
+	{
+		std::cout << "Symulacja N cial wymaga ukladu planetarnego (--stars)\n";
+		nbodyMode = false;
+	}
+
 	GLFWwindow* window;
 
 	glfwSetErrorCallback(errorCallback);
@@ -123,13 +272,22 @@ int main(int argc, char* argv[])
 		exit(2);
 	}
 
-	glfwSwapInterval(1); // v-sync on
+	glfwSwapInterval(benchmark ? 0 : 1); // v-sync on (wylaczony podczas pomiarow)
 
 	initGL();
 
+	if (benchmark)
+	{
+		runBenchmark(window);
+		glfwSetWindowShouldClose(window, GLFW_TRUE);
+	}
+
+	simClock.start(); // czas ladowania nie jest symulowany
+
 	while (!glfwWindowShouldClose(window))
 	{
 		renderScene();
+		updateWindowTitle(window);
 
 		glfwSwapBuffers(window);
 		glfwPollEvents();
@@ -174,12 +332,14 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 			rotationAngles.x += ROT_STEP;
 			if (rotationAngles.x > 360.0f)
 				rotationAngles.x -= 360.0f;
+			updateViewMatrix();
 			break;
 
 		case GLFW_KEY_S:
 			rotationAngles.x -= ROT_STEP;
 			if (rotationAngles.x < 0.0f)
 				rotationAngles.x += 360.0f;
+			updateViewMatrix();
 			break;
 
 		case GLFW_KEY_EQUAL: // =
@@ -200,6 +360,42 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
 		case GLFW_KEY_F1:
 			wireframe = !wireframe;
 			break;
+
+		case GLFW_KEY_F2:
+			wireframeMode = static_cast<WireframeMode>((wireframeMode + 1) % WIREFRAME_MODES);
+			if (systemStars > 0 && wireframeMode == WIREFRAME_BARYCENTRIC) // brak shadera barycentrycznego dla instancji
+				wireframeMode = WIREFRAME_POLYGON;
+			break;
+
+		case GLFW_KEY_F3:
+			if (gpuScene.program != 0)
+			{
+				gpuUpdate = !gpuUpdate;
+				std::cout << "Aktualizacja obiektow: " << (gpuUpdate ? "GPU" : "CPU") << std::endl;
+			}
+			break;
+
+		case GLFW_KEY_F4:
+			frustumCulling = !frustumCulling;
+			break;
+
+		case GLFW_KEY_F5:
+			occlusionCulling = !occlusionCulling;
+			break;
+
+		case GLFW_KEY_SPACE:
+			simClock.paused = !simClock.paused;
+			break;
+
+		case GLFW_KEY_LEFT: // symulacji N cial nie mozna przewijac
+			if (!nbodyMode)
+				simClock.seek(simClock.now() - SEEK_STEP);
+			break;
+
+		case GLFW_KEY_RIGHT:
+			if (!nbodyMode)
+				simClock.seek(simClock.now() + SEEK_STEP);
+			break;
 		}
 	}
 }
@@ -215,6 +411,8 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height)
 	glViewport(0, 0, width, height);
 
 	aspectRatio = static_cast<float>(width) / ((height == 0) ? 1 : height);
+	viewportWidth = width;
+	viewportHeight = height;
 	updateProjectionMatrix();
 }
 
@@ -224,6 +422,17 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height)
 void updateProjectionMatrix()
 {
 	projMatrix = glm::perspective(glm::radians(fovy), aspectRatio, 0.1f, 100.0f);
+	frameChanged = true;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja aktualizuje macierz widoku
+**------------------------------------------------------------------------------------------*/
+void updateViewMatrix()
+{
+	viewMatrix = glm::lookAt(glm::vec3(0, 0, 8), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+	viewMatrix = glm::rotate(viewMatrix, glm::radians(rotationAngles.x), glm::vec3(1.0f, 0.0f, 0.0f));
+	frameChanged = true;
 }
 
 /*------------------------------------------------------------------------------------------
@@ -231,9 +440,46 @@ void updateProjectionMatrix()
 **------------------------------------------------------------------------------------------*/
 void onShutdown()
 {
-	glDeleteBuffers(2, buffers);
-	glDeleteVertexArrays(1, &vao);
+	glDeleteBuffers(3, buffers);
+	glDeleteVertexArrays(2, vao);
 	glDeleteProgram(shaderProgram);
+	glDeleteProgram(wireframeProgram);
+	glDeleteProgram(multiDrawProgram);
+	glDeleteBuffers(1, &indirectBuffer);
+	glDeleteProgram(instancedProgram);
+	glDeleteVertexArrays(2, instanceVao);
+	glDeleteProgram(instancedGpuProgram);
+	gpuScene.destroy();
+	glDeleteProgram(instancedCullProgram);
+	gpuTimer.destroy();
+
+	uniformBlocks.objectRing.printStats("Dane obiektow");
+	uniformBlocks.destroy();
+
+	if (multiDraw)
+	{
+		drawData.printStats("Dane obiektow (SSBO)");
+		drawData.destroy();
+	}
+
+	if (systemStars > 0)
+	{
+		instanceData.printStats("Dane instancji");
+		instanceData.destroy();
+	}
+
+	if (nbodyMode)
+		simulation.printStats("Symulacja N cial");
+
+	if (culling.frames > 0)
+		culling.printStats("Odrzucanie obiektow");
+
+	if (gpuCulling.statsFrames > 0)
+		gpuCulling.printStats("Odrzucanie obiektow na GPU");
+	gpuCulling.destroy();
+	hiZ.destroy();
+
+	glState.printStats("Stan OpenGL");
 }
 
 /*------------------------------------------------------------------------------------------
@@ -251,10 +497,214 @@ void initGL()
 	glEnable(GL_DEPTH_TEST);
 
 	updateProjectionMatrix();
+	updateViewMatrix();
+
+	setupScene();
+
+	if (systemStars > 0) // uklad planetarny rysowany jest jednym wywolaniem z danymi instancji, bez UBO i SSBO obiektow
+		multiDraw = false;
+
+	uniformBlocks.init(systemStars > 0 ? 1 : scene.size(), persistentMapping);
+
+	if (multiDraw && !multiDrawSupported())
+	{
+		std::cout << "Brak OpenGL 4.3 lub ARB_shader_draw_parameters - rysowanie osobnymi glDrawElements\n";
+		multiDraw = false;
+	}
+
+	if (multiDraw)
+	{
+		GLint alignment;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+		drawData.init(GL_SHADER_STORAGE_BUFFER, scene.size() * sizeof(ObjectBlock), alignment, persistentMapping);
+	}
+
+	if (systemStars > 0)
+		instanceData.init(GL_ARRAY_BUFFER, scene.size() * sizeof(BodyInstance), sizeof(glm::vec4), persistentMapping);
 
 	setupShaders();
 
 	setupBuffers();
+
+	// orbity i hierarchia ukladu planetarnego przesylane sa do GPU raz - F3 przelacza sposob aktualizacji
+	if (systemStars > 0 && !nbodyMode && computeSupported())
+	{
+		if (!gpuScene.init(scene, packedColors))
+			exit(3);
+
+		if (!gpuCulling.init(gpuScene, meshLods, LOD_PIXELS, buffers[0], buffers[1], buffers[2]) || !hiZ.init())
+			exit(3);
+	}
+	else if (gpuUpdate)
+	{
+		std::cout << "Brak OpenGL 4.3, ukladu planetarnego lub tryb --nbody - aktualizacja obiektow na CPU\n";
+		gpuUpdate = false;
+	}
+
+	gpuTimer.init();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzaca hierarchie obiektow sceny
+**------------------------------------------------------------------------------------------*/
+void setupScene()
+{
+	scene.clear();
+	objectColors.clear();
+
+	if (systemStars > 0)
+	{
+		generateSystem();
+		scene.updateBounds(RADIUS);
+
+		if (nbodyMode)
+			setupNBody();
+		return;
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		scene.addNode(PARENT[i], ORBITS[i], SCALE[i]);
+		objectColors.push_back(glm::make_vec4(COLOR[i]));
+	}
+
+	scene.updateBounds(RADIUS);
+	objects.resize(scene.size());
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja generuje uklad planetarny - systemStars gwiazd, po systemPlanets planet kazdej
+** gwiazdy i po systemMoons ksiezycow kazdej planety; obiekty dodawane sa poziomami
+** (gwiazdy, planety, ksiezyce), wiec kazdy poziom jest jednym przedzialem SceneGraph
+** elementy orbit losowane sa ze stalym ziarnem, wiec uklad jest zawsze taki sam
+**------------------------------------------------------------------------------------------*/
+void generateSystem()
+{
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+	// promien ukladu jednej gwiazdy - gwiazdy zajmuja kolo o promieniu GALAXY_RADIUS
+	const float systemRadius = GALAXY_RADIUS / std::sqrt(static_cast<float>(systemStars));
+	const float TWO_PI = glm::two_pi<float>();
+
+	packedColors.clear();
+	scene.reserve(systemStars * (1 + systemPlanets * (1 + systemMoons)));
+	packedColors.reserve(systemStars * (1 + systemPlanets * (1 + systemMoons)));
+
+	auto addBody = [](int parent, const Orbit& orbit, float scale, const glm::vec4& color)
+	{
+		scene.addNode(parent, orbit, scale);
+		packedColors.push_back(glm::u8vec4(color * 255.0f));
+	};
+
+	for (int s = 0; s < systemStars; s++) // gwiazdy - rownomiernie w kole, powoli wokol jego srodka
+	{
+		const float distance = (systemStars == 1) ? 0.0f : GALAXY_RADIUS * std::sqrt(uniform(random));
+		const Orbit orbit = { distance, 0.0f, glm::radians(2.0f), TWO_PI * uniform(random), 0.0f };
+
+		addBody(-1, orbit, 0.2f * systemRadius, glm::vec4(1.0f, 0.8f + 0.2f * uniform(random), 0.3f * uniform(random), 1.0f));
+	}
+
+	for (int s = 0; s < systemStars; s++) // planety - okres orbity rosnie z odlegloscia (III prawo Keplera)
+	{
+		for (int p = 0; p < systemPlanets; p++)
+		{
+			const float distance = 0.4f + 0.6f * uniform(random); // wzgledem promienia ukladu
+			const Orbit orbit = { distance * systemRadius, 0.1f * uniform(random), glm::radians(18.0f) / std::pow(distance, 1.5f),
+				TWO_PI * uniform(random), TWO_PI * uniform(random) };
+
+			addBody(s, orbit, 0.07f * systemRadius, glm::vec4(0.2f + 0.3f * uniform(random), 0.3f + 0.5f * uniform(random), 0.6f + 0.4f * uniform(random), 1.0f));
+		}
+	}
+
+	for (int p = 0; p < systemStars * systemPlanets; p++) // ksiezyce - szybkie, czesc z nich w ruchu wstecznym
+	{
+		for (int m = 0; m < systemMoons; m++)
+		{
+			const float direction = (uniform(random) < 0.8f) ? 1.0f : -1.0f;
+			const Orbit orbit = { (0.08f + 0.1f * uniform(random)) * systemRadius, 0.05f * uniform(random),
+				direction * glm::radians(300.0f) * (0.5f + uniform(random)), TWO_PI * uniform(random), 0.0f };
+
+			const float grey = 0.6f + 0.4f * uniform(random);
+			addBody(systemStars + p, orbit, 0.008f * systemRadius, glm::vec4(grey, grey, grey, 1.0f));
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzy symulacje N cial z ukladu planetarnego - polozenia cial odpowiadaja
+** orbitom w chwili 0, a predkosci ruchowi po okregu wokol rodzica (gwiazdy - wokol srodka
+** ukladu, pod wplywem masy blizszych gwiazd z ich planetami i ksiezycami); stala grawitacji
+** dobrana jest tak, aby planeta w odleglosci promienia ukladu obiegala gwiazde tak szybko
+** jak w generateSystem
+** uklad nie jest stabilny - uklady sasiednich gwiazd zachodza na siebie, a ksiezyce kraza
+** dalej od planet niz siega ich przyciaganie, wiec z czasem planety i ksiezyce sa gubione
+**------------------------------------------------------------------------------------------*/
+void setupNBody()
+{
+	const int count = scene.size();
+	const float systemRadius = GALAXY_RADIUS / std::sqrt(static_cast<float>(systemStars)); // jak w generateSystem
+	const float planetMotion = glm::radians(18.0f);
+
+	scene.updateOrbits(0.0);
+	scene.updateWorldMatrices();
+
+	std::vector<float> masses(count);
+	std::vector<float> systemMasses(systemStars, 0.0f); // masa gwiazdy z jej planetami i ksiezycami
+	std::vector<glm::vec3> velocities(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		const int parent = scene.parents[i];
+		int star = i;
+		while (scene.parents[star] >= 0)
+			star = scene.parents[star];
+
+		masses[i] = (parent < 0) ? 1.0f : (scene.parents[parent] < 0) ? PLANET_MASS : MOON_MASS;
+		systemMasses[star] += masses[i];
+	}
+
+	const float gravity = planetMotion * planetMotion * systemRadius * systemRadius * systemRadius;
+
+	// gwiazdy - predkosc kolowa od masy ukladow gwiazd blizszych srodka (wraz z wlasnym)
+	std::vector<int> stars(systemStars);
+	std::iota(stars.begin(), stars.end(), 0);
+	std::sort(stars.begin(), stars.end(), [](int a, int b) { return scene.orbits[a].semiMajorAxis < scene.orbits[b].semiMajorAxis; });
+
+	float enclosedMass = 0.0f;
+	for (int star : stars)
+	{
+		enclosedMass += systemMasses[star];
+
+		const glm::vec3 position(scene.worldMatrices[star][3]);
+		const float radius = glm::length(position);
+
+		velocities[star] = (radius > 0.0f) ? std::sqrt(gravity * enclosedMass / radius) * glm::normalize(glm::vec3(-position.y, position.x, 0.0f))
+			: glm::vec3(0.0f);
+	}
+
+	// planety i ksiezyce - predkosc kolowa wzgledem rodzica w kierunku ruchu orbity
+	for (int i = systemStars; i < count; i++)
+	{
+		const int parent = scene.parents[i];
+		const glm::vec3 offset = glm::vec3(scene.worldMatrices[i][3]) - glm::vec3(scene.worldMatrices[parent][3]);
+		const float radius = glm::length(offset);
+		const float direction = (scene.orbits[i].meanMotion < 0.0f) ? -1.0f : 1.0f;
+
+		velocities[i] = velocities[parent]
+			+ direction * std::sqrt(gravity * (masses[parent] + masses[i]) / radius) * glm::normalize(glm::vec3(-offset.y, offset.x, 0.0f));
+	}
+
+	simulation.clear();
+	simulation.reserve(count);
+	simulation.gravity = gravity;
+	simulation.softening = 0.01f * systemRadius;
+
+	for (int i = 0; i < count; i++)
+		simulation.addBody(glm::vec3(scene.worldMatrices[i][3]), velocities[i], masses[i]);
+
+	simulation.start();
 }
 
 /*------------------------------------------------------------------------------------------
@@ -266,10 +716,36 @@ void setupShaders()
 		exit(3);
 
 	vertexLoc = glGetAttribLocation(shaderProgram, "vPosition");
-	colorLoc = glGetUniformLocation(shaderProgram, "color");
 
-	projMatrixLoc = glGetUniformLocation(shaderProgram, "projectionMatrix");
-	mvMatrixLoc = glGetUniformLocation(shaderProgram, "modelViewMatrix");
+	if (!setupShaders("shaders/vertex.vert", "shaders/wireframe.geom", "shaders/wireframe.frag", wireframeProgram))
+		exit(3);
+
+	uniformBlocks.bindProgram(shaderProgram);
+	uniformBlocks.bindProgram(wireframeProgram);
+
+	if (systemStars > 0)
+	{
+		if (!setupShaders("shaders/instanced.vert", "shaders/instanced.frag", instancedProgram))
+			exit(3);
+
+		uniformBlocks.bindProgram(instancedProgram);
+
+		if (computeSupported())
+		{
+			if (!setupShaders("shaders/instancedgpu.vert", "shaders/instanced.frag", instancedGpuProgram))
+				exit(3);
+
+			uniformBlocks.bindProgram(instancedGpuProgram);
+
+			if (!setupShaders("shaders/instancedcull.vert", "shaders/instanced.frag", instancedCullProgram))
+				exit(3);
+
+			uniformBlocks.bindProgram(instancedCullProgram);
+		}
+	}
+
+	if (multiDraw && !setupShaders("shaders/multidraw.vert", "shaders/multidraw.frag", multiDrawProgram))
+		exit(3);
 }
 
 /*------------------------------------------------------------------------------------------
@@ -277,157 +753,680 @@ void setupShaders()
 **------------------------------------------------------------------------------------------*/
 void setupBuffers()
 {
-	std::vector<float> vertices;
+	Stopwatch stopwatch;
 
-	generateSphereVertices(vertices);
+	// poziomy szczegolowosci siatki zapisane sa kolejno we wspolnych buforach - poziom 0
+	// zaczyna sie od poczatku buforow, wiec rysowania bez poziomow uzywaja tylko jego
+	int verticesNumber = 0;
+	int indicesTotal = 0;
 
-	std::vector<unsigned int> indices;
+	for (int lod = 0; lod < GpuCulling::LOD_COUNT; lod++)
+	{
+		meshLods[lod].baseVertex = verticesNumber;
+		meshLods[lod].firstIndex = indicesTotal;
+		meshLods[lod].indexCount = surfaceIndexCount(LOD_V_MAX[lod], LOD_U_MAX[lod], SPHERE.hasPoles());
 
-	generateSphereIndices(indices);
+		verticesNumber += surfaceVertexCount(LOD_V_MAX[lod], LOD_U_MAX[lod]);
+		indicesTotal += meshLods[lod].indexCount;
+	}
 
-	indicesNumber = (GLuint)indices.size();
+	indicesNumber = meshLods[0].indexCount;
 
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	glGenVertexArrays(2, vao);
+	glBindVertexArray(vao[0]);
 
-	glGenBuffers(2, buffers);
-	// VBO dla wierzcholkow
+	glGenBuffers(3, buffers);
+	// VBO dla wierzcholkow - sfery generowane bezposrednio w zmapowanej pamieci bufora
 	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), reinterpret_cast<GLfloat*>(&vertices[0]), GL_STATIC_DRAW);
+	fillBuffer<float>(GL_ARRAY_BUFFER, 4 * verticesNumber * sizeof(float), [](float* vertices)
+	{
+		for (int lod = 0; lod < GpuCulling::LOD_COUNT; lod++)
+			generateSurfaceVertices(SPHERE, LOD_V_MAX[lod], LOD_U_MAX[lod], vertices + 4 * meshLods[lod].baseVertex);
+	});
 	glEnableVertexAttribArray(vertexLoc);
 	glVertexAttribPointer(vertexLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
 
 	// VBO dla indeksow
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), reinterpret_cast<GLuint*>(&indices[0]), GL_STATIC_DRAW);
+	fillBuffer<unsigned int>(GL_ELEMENT_ARRAY_BUFFER, indicesTotal * sizeof(unsigned int), [](unsigned int* indices)
+	{
+		for (int lod = 0; lod < GpuCulling::LOD_COUNT; lod++)
+			generateSurfaceIndices(LOD_V_MAX[lod], LOD_U_MAX[lod], SPHERE.hasPoles(), indices + meshLods[lod].firstIndex);
+	});
+
+	// VAO i VBO dla unikalnych krawedzi (GL_LINES); indeksy trojkatow sa generowane
+	// ponownie, bo bufor indeksow zapisywany byl w zmapowanej pamieci GPU
+	std::vector<unsigned int> edges;
+	std::vector<unsigned int> lodEdges;
+
+	for (int lod = 0; lod < GpuCulling::LOD_COUNT; lod++)
+	{
+		std::vector<unsigned int> indices(meshLods[lod].indexCount);
+		generateSurfaceIndices(LOD_V_MAX[lod], LOD_U_MAX[lod], SPHERE.hasPoles(), indices.data());
+
+		extractEdges(indices.data(), static_cast<int>(indices.size()), lodEdges);
+
+		meshLods[lod].firstEdge = static_cast<GLuint>(edges.size());
+		meshLods[lod].edgeCount = static_cast<GLuint>(lodEdges.size());
+		edges.insert(edges.end(), lodEdges.begin(), lodEdges.end());
+	}
+
+	edgesNumber = meshLods[0].edgeCount;
+
+	glBindVertexArray(vao[1]);
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+	glEnableVertexAttribArray(vertexLoc);
+	glVertexAttribPointer(vertexLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[2]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, edges.size() * sizeof(unsigned int), edges.data(), GL_STATIC_DRAW);
+
+	// VAO ukladu planetarnego - te same wierzcholki i indeksy oraz atrybuty instancji, ktore
+	// wskazuja dane biezacej klatki w instanceData (ustawiane przed kazdym rysowaniem)
+	if (systemStars > 0)
+	{
+		glGenVertexArrays(2, instanceVao);
+
+		for (int i = 0; i < 2; i++)
+		{
+			glBindVertexArray(instanceVao[i]);
+
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+			glEnableVertexAttribArray(vertexLoc);
+			glVertexAttribPointer(vertexLoc, 4, GL_FLOAT, GL_FALSE, 0, 0);
+
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[i == 0 ? 1 : 2]);
+
+			for (int location = 1; location <= 5; location++)
+			{
+				glEnableVertexAttribArray(location);
+				glVertexAttribDivisor(location, 1);
+			}
+		}
+	}
 
 	glBindVertexArray(0);
+
+	// polecenia rysowania posredniego - te same dane siatki dla kazdego obiektu, a numer
+	// polecenia (gl_DrawIDARB) wybiera dane obiektu
+	if (multiDraw)
+	{
+		const int count = scene.size();
+		std::vector<DrawElementsIndirectCommand> commands(2 * count);
+
+		for (int i = 0; i < count; i++)
+		{
+			commands[i] = { static_cast<GLuint>(indicesNumber), 1, 0, 0, 0 };
+			commands[count + i] = { static_cast<GLuint>(edgesNumber), 1, 0, 0, 0 };
+		}
+
+		glGenBuffers(1, &indirectBuffer);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STATIC_DRAW);
+	}
+
+	glState.invalidate(); // VAO i bufory dowiazywane byly z pominieciem glState
+
+	glFinish(); // czas ladowania obejmuje przeslanie danych do GPU
+	std::cout << "Siatka: " << verticesNumber << " wierzcholkow, " << indicesTotal << " indeksow (" << GpuCulling::LOD_COUNT << " poziomy szczegolowosci), " << stopwatch.elapsedMs() << " ms" << std::endl;
+	printMemoryUsage("Siatka");
 }
 
 /*------------------------------------------------------------------------------------------
-** funkcja rysujaca scene
+** funkcja rysujaca scene - polozenia obiektow wyznaczane sa z orbit dla biezacego czasu
+** symulacji (w trybie gpuUpdate przez shader obliczeniowy, wliczany do czasu GPU)
 **------------------------------------------------------------------------------------------*/
 void renderScene()
 {
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	const int steps = simClock.advance();
 
-	glUseProgram(shaderProgram);
-	glUniformMatrix4fv(projMatrixLoc, 1, GL_FALSE, glm::value_ptr(projMatrix));
+	gpuTimer.begin();
 
-	if (wireframe)
+	Stopwatch updateStopwatch;
+	if (nbodyMode)
 	{
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		glLineWidth(lineWidth);
+		for (int s = 0; s < glm::min(steps, NBODY_MAX_STEPS); s++)
+			simulation.step(static_cast<float>(simClock.step));
 	}
+	else if (gpuUpdate)
+		gpuScene.update(glState, simClock.now());
 	else
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	{
+		scene.updateOrbits(simClock.now());
+		scene.updateWorldMatrices();
+	}
+	updateMs += updateStopwatch.elapsedMs();
 
-	for (int i = 0; i < 3; i++)
+	// obiekty poza ostroslupem nie sa rysowane - obiekty aktualizowane na GPU odrzucane sa
+	// shaderem obliczeniowym (wliczanym do czasu GPU), ktory wybiera tez poziom szczegolowosci
+	// i odrzuca obiekty zasloniete (siatka nie zaslania obiektow, wiec tylko przy wypelnieniu)
+	const glm::mat4 viewProjection = projMatrix * viewMatrix;
+	const bool occlusion = gpuUpdate && frustumCulling && occlusionCulling && !wireframe && viewportWidth > 0 && viewportHeight > 0;
+
+	Frustum frustum;
+	frustum.extract(viewProjection);
+
+	if (!occlusion)
+		hiZ.valid = false; // piramida nie bedzie aktualizowana
+
+	if (gpuUpdate)
 	{
-		if (i == 0)
+		if (frustumCulling)
 		{
-			mvMatrix = glm::lookAt(glm::vec3(0, 0, 8), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
-			mvMatrix = glm::rotate(mvMatrix, glm::radians(rotationAngles.x), glm::vec3(1.0f, 0.0f, 0.0f));
+			const glm::vec3 camera = glm::vec3(glm::inverse(viewMatrix)[3]);
+			const float lodScale = 0.5f * projMatrix[1][1] * viewportHeight;
+
+			gpuCulling.cull(glState, gpuScene, frustum, viewProjection, camera, lodScale, RADIUS, occlusion ? &hiZ : nullptr);
 		}
+	}
+	else if (frustumCulling)
+	{
+		if (nbodyMode)
+			culling.cullBodies(simulation.bodies.data(), simulation.ids.data(), scene.scales, simulation.size(), frustum, RADIUS);
 		else
+			culling.cull(scene, frustum, RADIUS);
+	}
+	else
+		culling.acceptAll(scene.size());
+
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	bool edges = wireframe && wireframeMode == WIREFRAME_EDGES;
+	bool barycentric = wireframe && wireframeMode == WIREFRAME_BARYCENTRIC;
+
+	if (frameChanged) // macierz projekcji i widoku zapisywane sa tylko po zmianie
+	{
+		const FrameBlock frame = { projMatrix, viewMatrix, lineWidth, {} };
+		uniformBlocks.updateFrame(frame);
+		frameChanged = false;
+	}
+
+	if (wireframe && wireframeMode == WIREFRAME_POLYGON)
+		glState.polygonMode(GL_LINE);
+	else
+		glState.polygonMode(GL_FILL); // GL_LINES i WIREFRAME_BARYCENTRIC rysowane sa bez trybu GL_LINE
+
+	glState.lineWidth(lineWidth);
+
+	if (systemStars > 0)
+	{
+		if (gpuUpdate)
+			renderInstancedGpu(edges, occlusion);
+		else if (culling.visibleCount() > 0)
+			renderInstanced(edges);
+		gpuTimer.end();
+		glState.endFrame();
+		return;
+	}
+
+	const int count = culling.visibleCount(); // dane widocznych obiektow zapisywane sa kolejno od poczatku objects
+
+	for (int k = 0; k < count; k++)
+	{
+		const int i = culling.visible[k];
+		mvMatrix = viewMatrix * scene.modelMatrix(i);
+
+		objects[k].mvpMatrix = projMatrix * mvMatrix;
+		objects[k].color = objectColors[i];
+		objects[k].fillColor = objectColors[i] * glm::vec4(fillFactor, fillFactor, fillFactor, 1.0f);
+	}
+
+	if (count == 0) // nic do narysowania - bufory danych obiektow nie sa mapowane
+	{
+		gpuTimer.end();
+		glState.endFrame();
+		return;
+	}
+
+	if (multiDraw && !barycentric) // shader barycentryczny czyta dane obiektu z UBO
+	{
+		renderMultiDraw(objects.data(), count, edges);
+		gpuTimer.end();
+		glState.endFrame();
+		return;
+	}
+
+	uniformBlocks.updateObjects(objects.data(), count);
+
+	// wszystkie obiekty korzystaja z tej samej siatki i programu, wiec kolejka sortuje je
+	// tylko wedlug glebokosci srodka obiektu (od najblizszego)
+	for (int i = 0; i < count; i++)
+	{
+		RenderCommand command;
+
+		// WIREFRAME_BARYCENTRIC - wypelnienie i krawedzie o dowolnej grubosci w jednym przebiegu
+		command.program = barycentric ? wireframeProgram : shaderProgram;
+		command.vertexArray = vao[edges ? 1 : 0];
+		command.objectBuffer = uniformBlocks.objectRange(i);
+		command.type = DRAW_ELEMENTS;
+		command.mode = edges ? GL_LINES : GL_TRIANGLES;
+		command.count = edges ? edgesNumber : indicesNumber;
+
+		const glm::vec4 center = objects[i].mvpMatrix[3]; // srodek obiektu we wspolrzednych przyciecia
+		renderQueue.submit(command, 0, 0.5f * center.z / center.w + 0.5f);
+	}
+
+	renderQueue.flush(glState);
+
+	uniformBlocks.endFrame();
+	gpuTimer.end();
+	glState.endFrame();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rysujaca wszystkie obiekty jednym wywolaniem glMultiDrawElementsIndirect - dane
+** obiektow zapisywane sa do SSBO, z ktorego shader wybiera je numerem rysowania
+** objects - dane obiektow
+** count - liczba obiektow (pierwsze count polecen z bufora posredniego)
+** edges - czy rysowac krawedzie (GL_LINES) zamiast trojkatow
+**------------------------------------------------------------------------------------------*/
+void renderMultiDraw(const ObjectBlock* objects, int count, bool edges)
+{
+	drawData.beginFrame();
+
+	GLintptr offset;
+	void* data = drawData.map(count * sizeof(ObjectBlock), offset);
+	std::memcpy(data, objects, count * sizeof(ObjectBlock));
+	drawData.unmap();
+
+	RenderCommand command;
+
+	command.program = multiDrawProgram;
+	command.vertexArray = vao[edges ? 1 : 0];
+	command.objectBuffer.target = GL_SHADER_STORAGE_BUFFER;
+	command.objectBuffer.index = DRAW_DATA_BINDING;
+	command.objectBuffer.buffer = drawData.buffer;
+	command.objectBuffer.offset = offset;
+	command.objectBuffer.size = count * sizeof(ObjectBlock);
+	command.type = DRAW_ELEMENTS_INDIRECT;
+	command.mode = edges ? GL_LINES : GL_TRIANGLES;
+	command.first = (edges ? scene.size() : 0) * sizeof(DrawElementsIndirectCommand); // polecenia krawedzi po poleceniach trojkatow wszystkich obiektow
+	command.count = count;
+	command.indirectBuffer = indirectBuffer;
+
+	renderQueue.submit(command);
+	renderQueue.flush(glState);
+
+	drawData.endFrame();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rysujaca widoczne obiekty ukladu planetarnego jednym wywolaniem
+** glDrawElementsInstanced - macierze modelu i kolory obiektow zapisywane sa rownolegle do
+** bufora danych instancji, a wskazniki atrybutow instancji ustawiane na dane tej klatki
+** edges - czy rysowac krawedzie (GL_LINES) zamiast trojkatow
+**------------------------------------------------------------------------------------------*/
+void renderInstanced(bool edges)
+{
+	const int count = culling.visibleCount(); // rysowane sa tylko obiekty widoczne
+
+	instanceData.beginFrame();
+
+	Stopwatch stopwatch;
+
+	GLintptr offset;
+	BodyInstance* instances = static_cast<BodyInstance*>(instanceData.map(count * sizeof(BodyInstance), offset));
+
+	if (nbodyMode) // ciala symulacji sa przestawiane - kolor i skale wskazuje numer ciala (wezla sceny)
+	{
+		#pragma omp parallel for
+		for (int k = 0; k < count; k++)
 		{
-			mvMatrix = tempMat; // macierz z poprzedniego obiektu, aby przesunac i obrocic względem niego
+			const int i = culling.visible[k];
+			const glm::vec4& body = simulation.bodies[i];
+			const int id = simulation.ids[i];
+			const float scale = scene.scales[id];
+
+			instances[k].modelMatrix = glm::mat4x3(scale, 0.0f, 0.0f, 0.0f, scale, 0.0f, 0.0f, 0.0f, scale, body.x, body.y, body.z);
+			instances[k].color = packedColors[id];
+		}
+	}
+	else
+	{
+		#pragma omp parallel for
+		for (int k = 0; k < count; k++)
+		{
+			const int i = culling.visible[k];
+			instances[k].modelMatrix = glm::mat4x3(scene.modelMatrix(i));
+			instances[k].color = packedColors[i];
 		}
-		
-		mvMatrix = glm::rotate(mvMatrix, glm::radians(rotation[i]), glm::vec3(0.0f, 0.0f, 1.0f));
-		mvMatrix = glm::translate(mvMatrix, glm::vec3(OFFSET[i], 0.0f, 0.0f));
+	}
+
+	instanceData.unmap();
+
+	updateMs += stopwatch.elapsedMs();
+
+	const GLuint vertexArray = instanceVao[edges ? 1 : 0];
 
-		rotation[i] += ROT_RATE[i];
+	glState.bindVertexArray(vertexArray);
+	glState.bindBuffer(GL_ARRAY_BUFFER, instanceData.buffer);
 
-		if (rotation[i] > 360.0f)
-			rotation[i] -= 360.0f;
+	for (int c = 0; c < 4; c++) // macierz 4x3 zajmuje cztery kolejne lokalizacje atrybutow
+		glVertexAttribPointer(1 + c, 3, GL_FLOAT, GL_FALSE, sizeof(BodyInstance), reinterpret_cast<void*>(offset + offsetof(BodyInstance, modelMatrix) + c * sizeof(glm::vec3)));
 
-		if (rotation[i] < 0.0f)
-			rotation[i] += 360.0f;
+	glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(BodyInstance), reinterpret_cast<void*>(offset + offsetof(BodyInstance, color)));
 
-		tempMat = mvMatrix;
+	RenderCommand command;
 
-		mvMatrix = glm::scale(mvMatrix, glm::vec3(SCALE[i], SCALE[i], SCALE[i]));
-		
-		glUniformMatrix4fv(mvMatrixLoc, 1, GL_FALSE, glm::value_ptr(mvMatrix));
-		
-		glBindVertexArray(vao);
-		glUniform4fv(colorLoc, 1, COLOR[i]);
-		glDrawElements(GL_TRIANGLES, indicesNumber, GL_UNSIGNED_INT, 0);
+	command.program = instancedProgram;
+	command.vertexArray = vertexArray;
+	command.type = DRAW_ELEMENTS;
+	command.mode = edges ? GL_LINES : GL_TRIANGLES;
+	command.count = edges ? edgesNumber : indicesNumber;
+	command.instances = count;
+
+	renderQueue.submit(command);
+	renderQueue.flush(glState);
+
+	instanceData.endFrame();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rysujaca wszystkie obiekty ukladu planetarnego jednym wywolaniem
+** glDrawElementsInstanced - macierze swiata, skale i kolory obiektow shader wierzcholkow
+** czyta numerem instancji z SSBO wypelnionych przez gpuScene, bez przesylania danych z CPU;
+** przy odrzucaniu obiektow rysowane sa tylko obiekty wybrane przez gpuCulling, jednym
+** glMultiDrawElementsIndirect z poleceniem dla kazdego poziomu szczegolowosci; przy
+** odrzucaniu zaslonietych obiektow piramida glebokosci budowana jest po narysowaniu
+** obiektow pierwszej fazy, a obiekty widoczne dopiero w drugiej fazie rysowane sa osobno
+** edges - czy rysowac krawedzie (GL_LINES) zamiast trojkatow
+** occlusion - czy odrzucane sa obiekty zasloniete (dwie fazy odrzucania)
+**------------------------------------------------------------------------------------------*/
+void renderInstancedGpu(bool edges, bool occlusion)
+{
+	RenderCommand command; // bariera po gpuScene.update udostepnia macierze swiata shaderowi wierzcholkow
+
+	if (frustumCulling) // bariera po gpuCulling.cull udostepnia polecenia i indeksy widocznych obiektow
+	{
+		command.program = instancedCullProgram;
+		command.vertexArray = gpuCulling.vertexArrays[edges ? 1 : 0];
+		command.type = DRAW_ELEMENTS_INDIRECT;
+		command.mode = edges ? GL_LINES : GL_TRIANGLES;
+		command.first = (edges ? GpuCulling::LOD_COUNT : 0) * sizeof(DrawElementsIndirectCommand);
+		command.count = GpuCulling::LOD_COUNT;
+		command.indirectBuffer = gpuCulling.commandBuffer;
+
+		renderQueue.submit(command);
+		renderQueue.flush(glState);
+
+		if (occlusion)
+		{
+			hiZ.build(glState, viewportWidth, viewportHeight);
+			gpuCulling.retest(glState, gpuScene, hiZ);
+
+			command.first += GpuCulling::COMMAND_COUNT * sizeof(DrawElementsIndirectCommand); // polecenia drugiej fazy
+
+			renderQueue.submit(command);
+			renderQueue.flush(glState);
+		}
+
+		gpuCulling.collectStats(glState);
+		return;
 	}
 
-	glBindVertexArray(0);
+	command.program = instancedGpuProgram;
+	command.vertexArray = vao[edges ? 1 : 0];
+	command.type = DRAW_ELEMENTS;
+	command.mode = edges ? GL_LINES : GL_TRIANGLES;
+	command.count = edges ? edgesNumber : indicesNumber;
+	command.instances = gpuScene.count;
+
+	renderQueue.submit(command);
+	renderQueue.flush(glState);
 }
 
-void generateSphereVertices(std::vector<float> &vertices)
+/*------------------------------------------------------------------------------------------
+** funkcja wyswietla w tytule okna liczbe widocznych i odrzuconych obiektow ostatniej klatki
+** (tytul zmieniany jest tylko, gdy liczby sie zmienily)
+** window - okno, w ktorym rysowana jest scena
+**------------------------------------------------------------------------------------------*/
+void updateWindowTitle(GLFWwindow* window)
 {
-	float fi, fiMin, fiMax, theta;
+	static int shownVisible = -1;
+	static bool shownCulling = false;
 
-	if (Z_MIN > -RADIUS)
-		fiMin = asin(Z_MIN / RADIUS);
-	else if (Z_MIN <= -RADIUS)
-		fiMin = -90.0f * ((float)M_PI / 180);
+	const int visibleCount = gpuUpdate ? gpuCulling.lastVisible() : culling.visibleCount(); // na GPU - z opoznieniem kilku klatek
 
-	if (Z_MAX < RADIUS)
-		fiMax = asin(Z_MAX / RADIUS);
-	else if (Z_MAX >= RADIUS)
-		fiMax = 90.0f * ((float)M_PI / 180);
+	if (visibleCount == shownVisible && frustumCulling == shownCulling)
+		return;
 
-	const float V_STEP = 1.0f / V_MAX;
-	const float U_STEP = 1.0f / U_MAX;
+	shownVisible = visibleCount;
+	shownCulling = frustumCulling;
 
-	float v = 0.0f, u = 0.0f;
+	std::string title = "Zadanie 3";
+	if (frustumCulling)
+		title += " - widoczne " + std::to_string(visibleCount) + ", odrzucone " + std::to_string(scene.size() - visibleCount);
+	if (frustumCulling && gpuUpdate && gpuCulling.lastOccluded > 0)
+		title += " (zasloniete " + std::to_string(gpuCulling.lastOccluded) + ")";
 
-	//std::cout << fiMin << " " << fiMax << ", " << V_STEP << " " << U_STEP << std::endl;
+	glfwSetWindowTitle(window, title.c_str());
+}
 
-	for (int i = 0; i < V_MAX + 1; i++)
+/*------------------------------------------------------------------------------------------
+** funkcja porownuje czas rysowania siatki kolejnymi sposobami i wyswietla wyniki; zegar
+** symulacji jest wirtualny i zerowany przed kazdym wariantem, wiec kazdy z nich rysuje te
+** same klatki niezaleznie od osiaganej liczby klatek na sekunde; jesli dostepny jest
+** gpuScene, kazdy sposob mierzony jest z aktualizacja obiektow na CPU i na GPU
+** window - okno, w ktorym rysowana jest scena
+**------------------------------------------------------------------------------------------*/
+void runBenchmark(GLFWwindow* window)
+{
+	const char* MODE_NAMES[] = { "glPolygonMode(GL_LINE)", "GL_LINES", "barycentric" };
+
+	wireframe = true;
+	simClock.virtualTime = true;
+
+	const bool gpuUpdateOption = gpuUpdate;
+	const int updatePaths = (gpuScene.program != 0) ? 2 : 1; // aktualizacja obiektow na CPU, a nastepnie na GPU
+
+	for (int variant = 0; variant < WIREFRAME_MODES * updatePaths; variant++)
 	{
-		fi = fiMin + v * (fiMax - fiMin);
+		const int mode = variant % WIREFRAME_MODES;
 
-		for (int j = 0; j < U_MAX; j++)
-		{
-			theta = u * THETA_MAX;
+		if (systemStars > 0 && mode == WIREFRAME_BARYCENTRIC) // brak shadera barycentrycznego dla instancji
+			continue;
+
+		wireframeMode = static_cast<WireframeMode>(mode);
+		gpuUpdate = (variant >= WIREFRAME_MODES);
+
+		simClock.start();
 
-			vertices.push_back(RADIUS * cos(theta) * cos(fi));	// x
-			vertices.push_back(RADIUS * sin(theta) * cos(fi));	// y
-			vertices.push_back(RADIUS * sin(fi));				// z
-			vertices.push_back(1.0f);
+		if (nbodyMode) // kazdy wariant symuluje te same kroki od poczatku
+			setupNBody();
 
-			u += U_STEP;
+		glFinish();
+		gpuTimer.reset();
+		glState.resetStats();
+		culling.resetStats();
+		gpuCulling.resetStats();
+		updateMs = 0.0;
+		Stopwatch stopwatch;
+
+		for (int frame = 0; frame < BENCHMARK_FRAMES && !glfwWindowShouldClose(window); frame++)
+		{
+			renderScene();
+
+			glfwSwapBuffers(window);
+			glfwPollEvents();
 		}
-		v += V_STEP;
+
+		glFinish();
+
+		std::cout << "[benchmark] " << scene.size() << " obiektow, " << MODE_NAMES[mode] << (gpuScene.program != 0 ? (gpuUpdate ? ", aktualizacja GPU" : ", aktualizacja CPU") : "") << ": GPU " << gpuTimer.averageMs() << " ms, klatka "
+			<< stopwatch.elapsedMs() / BENCHMARK_FRAMES << " ms, aktualizacja obiektow " << updateMs / BENCHMARK_FRAMES << " ms, czas symulacji "
+			<< simClock.time << " s" << std::endl;
+		glState.printStats("[benchmark] stan OpenGL");
+
+		if (nbodyMode)
+			simulation.printStats("[benchmark] symulacja N cial");
+
+		if (gpuUpdate && frustumCulling)
+			gpuCulling.printStats("[benchmark] odrzucanie obiektow na GPU");
+		else if (frustumCulling)
+			culling.printStats("[benchmark] odrzucanie obiektow");
 	}
+
+	gpuUpdate = gpuUpdateOption;
+
+	runOcclusionBenchmark(window);
+
+	simClock.virtualTime = false;
+
+	runTransformBenchmark();
 }
 
-void generateSphereIndices(std::vector<unsigned int>& indices)
+/*------------------------------------------------------------------------------------------
+** funkcja porownuje czas GPU rysowania wypelnionych obiektow ukladu planetarnego
+** aktualizowanych na GPU bez odrzucania i z odrzucaniem zaslonietych obiektow (obiekty
+** poza ostroslupem odrzucane sa w obu wariantach) i wyswietla zysk czasu GPU
+** window - okno, w ktorym rysowana jest scena
+**------------------------------------------------------------------------------------------*/
+void runOcclusionBenchmark(GLFWwindow* window)
 {
-	int i = 0, j = 0, k;
+	if (gpuScene.program == 0)
+		return;
+
+	const bool wireframeOption = wireframe;
+	const bool gpuUpdateOption = gpuUpdate;
+	const bool frustumCullingOption = frustumCulling;
+	const bool occlusionOption = occlusionCulling;
+
+	wireframe = false;
+	gpuUpdate = true;
+	frustumCulling = true;
 
-	while (j < U_MAX)
+	double gpuMs[2];
+
+	for (int variant = 0; variant < 2; variant++)
 	{
-		j++;
-		k = j + 1;
+		occlusionCulling = (variant == 1);
+
+		simClock.start();
+
+		glFinish();
+		gpuTimer.reset();
+		gpuCulling.resetStats();
+		hiZ.valid = false;
 
-		indices.push_back(i);
-		indices.push_back(j);
-		indices.push_back(k);
+		for (int frame = 0; frame < BENCHMARK_FRAMES && !glfwWindowShouldClose(window); frame++)
+		{
+			renderScene();
+
+			glfwSwapBuffers(window);
+			glfwPollEvents();
+		}
 
-		//std::cout << i << " " << j << " " << k << std::endl;
+		glFinish();
+		gpuMs[variant] = gpuTimer.averageMs();
+
+		std::cout << "[benchmark] " << scene.size() << " obiektow, wypelnienie, aktualizacja GPU" << (occlusionCulling ? ", odrzucanie zaslonietych" : "")
+			<< ": GPU " << gpuMs[variant] << " ms" << std::endl;
+		gpuCulling.printStats("[benchmark] odrzucanie obiektow na GPU");
 	}
 
-	for (i = 2; i < V_MAX * U_MAX; i++)
+	std::cout << "[benchmark] odrzucanie zaslonietych obiektow: zysk czasu GPU " << gpuMs[0] - gpuMs[1] << " ms na klatke ("
+		<< (gpuMs[0] > 0.0 ? 100.0 * (gpuMs[0] - gpuMs[1]) / gpuMs[0] : 0.0) << "%)" << std::endl;
+
+	wireframe = wireframeOption;
+	gpuUpdate = gpuUpdateOption;
+	frustumCulling = frustumCullingOption;
+	occlusionCulling = occlusionOption;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja porownuje wyznaczanie macierzy swiata hierarchii obiektow lancuchem wywolan
+** glm::rotate i glm::translate (jak przed wprowadzeniem SceneGraph) z funkcja
+** composeWorldMatrices dla scen roznej wielkosci; scena to jeden korzen, planety (1%
+** obiektow) i ksiezyce planet zapisane poziomami drzewa
+**------------------------------------------------------------------------------------------*/
+void runTransformBenchmark()
+{
+	const int COUNTS[] = { 1000, 100000, 1000000 };
+	const int MATRICES_PER_TEST = 10000000; // liczba wyznaczanych macierzy dla kazdej wielkosci sceny
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+	for (int count : COUNTS)
 	{
-		j++;
-		k = j + 1;
+		const int planets = std::max(1, count / 100);
+
+		SceneGraph bench;
+		bench.reserve(count);
+
+		for (int i = 0; i < count; i++)
+		{
+			const int parent = (i == 0) ? -1 : (i <= planets) ? 0 : 1 + i % planets;
+			const Orbit orbit = { 0.1f + uniform(random), 0.3f * uniform(random), uniform(random), glm::two_pi<float>() * uniform(random), 0.0f };
+			bench.addNode(parent, orbit, 1.0f);
+		}
+
+		bench.updateOrbits(1.0);
+
+		std::vector<OrbitState> states(count);
+		for (int i = 0; i < count; i++)
+			states[i] = evaluateOrbit(bench.orbits[i], 1.0);
 
-		indices.push_back(i);
-		indices.push_back(j);
-		indices.push_back(k);
+		std::vector<glm::mat4> chained(count);
+		const int repeats = std::max(1, MATRICES_PER_TEST / count);
 
-		indices.push_back(i);
-		indices.push_back(j);
-		indices.push_back(i - 1);
+		Stopwatch glmStopwatch;
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				const glm::mat4 parent = (bench.parents[i] < 0) ? glm::mat4(1.0f) : chained[bench.parents[i]];
+				chained[i] = glm::translate(glm::rotate(parent, states[i].angle, glm::vec3(0.0f, 0.0f, 1.0f)), glm::vec3(states[i].radius, 0.0f, 0.0f));
+			}
+		}
+		const double glmMs = glmStopwatch.elapsedMs() / repeats;
+
+		std::cout << "[benchmark] macierze swiata, " << count << " obiektow: glm " << glmMs << " ms" << std::endl;
 
-		//std::cout << i << " " << j << " " << k << std::endl;
+		// SoA kolejno dla kazdego zestawu instrukcji obslugiwanego przez procesor
+		for (int level = SIMD_NONE; level <= detectSimdLevel(); level++)
+		{
+			setSimdLimit(static_cast<SimdLevel>(level));
+
+			Stopwatch soaStopwatch;
+			for (int repeat = 0; repeat < repeats; repeat++)
+				bench.updateWorldMatrices();
+			const double soaMs = soaStopwatch.elapsedMs() / repeats;
+
+			float difference = 0.0f;
+			for (int i = 0; i < count; i++)
+				for (int c = 0; c < 4; c++)
+					for (int r = 0; r < 4; r++)
+						difference = std::max(difference, std::abs(chained[i][c][r] - bench.worldMatrices[i][c][r]));
+
+			std::cout << "[benchmark] macierze swiata, " << count << " obiektow: SoA (" << simdName() << ") " << soaMs << " ms, maks. roznica "
+				<< difference << std::endl;
+		}
 	}
-}
\ No newline at end of file
+
+	setSimdLimit(SIMD_AVX512);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja odczytuje liczbe calkowita z argumentu wiersza polecen i ogranicza ja do
+** przedzialu [minValue, maxValue] (rowniez liczby spoza zakresu typu long); argument,
+** ktory nie jest liczba, pozostawia dotychczasowa wartosc
+** name - nazwa opcji (do komunikatu)
+** text - argument opcji
+** minValue, maxValue - dopuszczalny przedzial wartosci
+** value - wartosc opcji
+**------------------------------------------------------------------------------------------*/
+void parseIntOption(const char* name, const char* text, int minValue, int maxValue, int& value)
+{
+	char* end = nullptr;
+	const long parsed = std::strtol(text, &end, 10); // poza zakresem long - LONG_MIN lub LONG_MAX
+
+	if (end == text || *end != '\0')
+	{
+		std::cout << "Niepoprawna wartosc opcji " << name << ": \"" << text << "\", pozostaje " << value << "\n";
+		return;
+	}
+
+	value = static_cast<int>(glm::clamp(parsed, static_cast<long>(minValue), static_cast<long>(maxValue)));
+}
@@ -0,0 +1,403 @@
+#include "nbody.h"
+#include "perf.h"
+#include "simd.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+/*------------------------------------------------------------------------------------------
+** funkcja rozsuwa 21 mlodszych bitow liczby co trzy bity (bit i przechodzi na bit 3i)
+**------------------------------------------------------------------------------------------*/
+static std::uint64_t spreadBits(std::uint64_t v)
+{
+	v &= 0x1fffff;
+	v = (v | v << 32) & 0x1f00000000ffffull;
+	v = (v | v << 16) & 0x1f0000ff0000ffull;
+	v = (v | v << 8) & 0x100f00f00f00f00full;
+	v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+	v = (v | v << 2) & 0x1249249249249249ull;
+	return v;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa wszystkie ciala i dane drzewa
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::clear()
+{
+	bodies.clear();
+	velocities.clear();
+	accelerations.clear();
+	ids.clear();
+	nodes.clear();
+	time = 0.0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rezerwuje pamiec dla capacity cial
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::reserve(int capacity)
+{
+	bodies.reserve(capacity);
+	velocities.reserve(capacity);
+	accelerations.reserve(capacity);
+	ids.reserve(capacity);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja dodaje cialo o numerze rownym liczbie dodanych wczesniej cial
+** position - polozenie ciala
+** velocity - predkosc ciala
+** mass - masa ciala
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::addBody(const glm::vec3& position, const glm::vec3& velocity, float mass)
+{
+	ids.push_back(size());
+	bodies.push_back(glm::vec4(position, mass));
+	velocities.push_back(velocity);
+	accelerations.push_back(glm::vec3(0.0f));
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza przyspieszenia poczatkowe - wywolywana po dodaniu wszystkich cial
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::start()
+{
+	buildTree();
+	computeAccelerations();
+	resetStats();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wykonuje krok symulacji metoda leapfrog: pol kroku predkosci, pelny krok
+** polozen, nowe przyspieszenia i drugie pol kroku predkosci
+** dt - dlugosc kroku w sekundach
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::step(float dt)
+{
+	const int count = size();
+	const float halfStep = 0.5f * dt;
+
+	#pragma omp parallel for
+	for (int i = 0; i < count; i++)
+	{
+		velocities[i] += halfStep * accelerations[i];
+		bodies[i] += glm::vec4(dt * velocities[i], 0.0f);
+	}
+
+	Stopwatch buildStopwatch;
+	buildTree();
+	buildMs += buildStopwatch.elapsedMs();
+
+	Stopwatch forceStopwatch;
+	computeAccelerations();
+	forceMs += forceStopwatch.elapsedMs();
+
+	#pragma omp parallel for
+	for (int i = 0; i < count; i++)
+		velocities[i] += halfStep * accelerations[i];
+
+	time += dt;
+	steps++;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja sortuje ciala wedlug kodow Mortona ich polozen w szescianie otaczajacym
+** wszystkie ciala (sortowanie pozycyjne po 11 bitow) i przestawia dane cial w tej kolejnosci
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::sortBodies()
+{
+	const int count = size();
+	const int RADIX_BITS = 11;
+	const int RADIX = 1 << RADIX_BITS;
+
+	glm::vec3 lower(bodies[0]);
+	glm::vec3 upper(bodies[0]);
+	for (int i = 1; i < count; i++)
+	{
+		lower = glm::min(lower, glm::vec3(bodies[i]));
+		upper = glm::max(upper, glm::vec3(bodies[i]));
+	}
+
+	const float extent = glm::max(glm::max(upper.x - lower.x, upper.y - lower.y), glm::max(upper.z - lower.z, 1e-6f));
+	const float cells = static_cast<float>(1 << MORTON_BITS);
+	const float toCell = cells / extent * (1.0f - 1e-6f); // ciala na gornej scianie szescianu trafiaja do ostatniej komorki
+
+	codes.resize(count);
+	sortedCodes.resize(count);
+	order.resize(count);
+	sortedOrder.resize(count);
+
+	#pragma omp parallel for
+	for (int i = 0; i < count; i++)
+	{
+		const glm::vec3 cell = glm::min((glm::vec3(bodies[i]) - lower) * toCell, glm::vec3(cells - 1.0f));
+
+		codes[i] = spreadBits(static_cast<std::uint64_t>(cell.x)) << 2 | spreadBits(static_cast<std::uint64_t>(cell.y)) << 1
+			| spreadBits(static_cast<std::uint64_t>(cell.z));
+		order[i] = i;
+	}
+
+	// przebiegi, w ktorych wszystkie ciala maja te sama cyfre, nic nie zmieniaja i sa pomijane
+	std::vector<int> histogram(RADIX);
+
+	for (int shift = 0; shift < 3 * MORTON_BITS; shift += RADIX_BITS)
+	{
+		std::fill(histogram.begin(), histogram.end(), 0);
+		for (int i = 0; i < count; i++)
+			histogram[(codes[i] >> shift) & (RADIX - 1)]++;
+
+		if (histogram[(codes[0] >> shift) & (RADIX - 1)] == count)
+			continue;
+
+		int offset = 0;
+		for (int digit = 0; digit < RADIX; digit++)
+		{
+			const int digitCount = histogram[digit];
+			histogram[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			const int position = histogram[(codes[i] >> shift) & (RADIX - 1)]++;
+			sortedCodes[position] = codes[i];
+			sortedOrder[position] = order[i];
+		}
+
+		codes.swap(sortedCodes);
+		order.swap(sortedOrder);
+	}
+
+	sortedBodies.resize(count);
+	sortedVelocities.resize(count);
+	sortedIds.resize(count);
+
+	#pragma omp parallel for
+	for (int i = 0; i < count; i++)
+	{
+		sortedBodies[i] = bodies[order[i]];
+		sortedVelocities[i] = velocities[order[i]];
+		sortedIds[i] = ids[order[i]];
+	}
+
+	bodies.swap(sortedBodies);
+	velocities.swap(sortedVelocities);
+	ids.swap(sortedIds);
+
+	rootSize = extent;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja buduje od nowa drzewo osemkowe z cial posortowanych wedlug kodow Mortona
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::buildTree()
+{
+	nodes.clear();
+
+	if (bodies.empty())
+		return;
+
+	sortBodies();
+	buildNode(0, size(), 0, rootSize);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja dodaje wezel drzewa dla cial [first, last) lezacych w jednej komorce poziomu
+** level - dzieci to kolejne przedzialy cial o rownej cyfrze kodu Mortona na nastepnym
+** poziomie (ciala sa posortowane, wiec przedzialy wyznacza wyszukiwanie binarne)
+** first, last - przedzial cial wezla
+** level - glebokosc wezla (0 - korzen)
+** size - dlugosc krawedzi komorki wezla
+** funkcja zwraca indeks wezla
+**------------------------------------------------------------------------------------------*/
+int NBodySimulation::buildNode(int first, int last, int level, float size)
+{
+	const int index = static_cast<int>(nodes.size());
+	nodes.push_back(OctreeNode());
+
+	OctreeNode node;
+	node.first = first;
+	node.count = last - first;
+	node.openDistance2 = (size / theta) * (size / theta);
+
+	glm::vec4 mass(0.0f); // suma polozen wazonych masa (xyz) i masa (w)
+
+	if (last - first <= LEAF_SIZE || level == MORTON_BITS)
+	{
+		for (int i = first; i < last; i++)
+			mass += glm::vec4(glm::vec3(bodies[i]) * bodies[i].w, bodies[i].w);
+	}
+	else
+	{
+		const int shift = 3 * (MORTON_BITS - 1 - level);
+
+		for (int begin = first, digit = 0; begin < last; digit++)
+		{
+			const int end = static_cast<int>(std::partition_point(codes.begin() + begin, codes.begin() + last,
+				[shift, digit](std::uint64_t code) { return static_cast<int>((code >> shift) & 7) <= digit; }) - codes.begin());
+
+			if (end > begin)
+			{
+				const glm::vec4 child = nodes[buildNode(begin, end, level + 1, 0.5f * size)].centerOfMass;
+				mass += glm::vec4(glm::vec3(child) * child.w, child.w);
+				begin = end;
+			}
+		}
+	}
+
+	node.centerOfMass = (mass.w > 0.0f) ? glm::vec4(glm::vec3(mass) / mass.w, mass.w) : glm::vec4(0.0f);
+	node.next = static_cast<int>(nodes.size());
+
+	nodes[index] = node;
+	return index;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja dodaje przyspieszenia (bez stalej grawitacji) wywolane przez zrodla - srodki
+** masy wezlow lub ciala - do przyspieszen GROUP_SIZE cial grupy; jadro SIMD wybrane przez
+** simdKernels (SimdKernels::accumulateGroup), a bez niego petla skalarna
+** kernels - jadra SIMD (nullptr - brak SIMD)
+** sources - polozenia (xyz) i masy (w) zrodel
+** count - liczba zrodel
+** x, y, z - polozenia cial grupy
+** softening2 - kwadrat odleglosci wygladzania
+** ax, ay, az - przyspieszenia cial grupy
+**------------------------------------------------------------------------------------------*/
+static void accumulateGroup(const SimdKernels* kernels, const glm::vec4* sources, int count, const float* x, const float* y, const float* z,
+	float softening2, float* ax, float* ay, float* az)
+{
+	if (kernels)
+	{
+		kernels->accumulateGroup(reinterpret_cast<const float*>(sources), count, NBodySimulation::GROUP_SIZE, x, y, z, softening2, ax, ay, az);
+		return;
+	}
+
+	for (int s = 0; s < count; s++)
+	{
+		for (int k = 0; k < NBodySimulation::GROUP_SIZE; k++)
+		{
+			const float dx = sources[s].x - x[k];
+			const float dy = sources[s].y - y[k];
+			const float dz = sources[s].z - z[k];
+			const float inverse = 1.0f / std::sqrt(dx * dx + dy * dy + dz * dz + softening2);
+			const float strength = sources[s].w * inverse * inverse * inverse;
+
+			ax[k] += dx * strength;
+			ay[k] += dy * strength;
+			az[k] += dz * strength;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza przyspieszenia wszystkich cial - drzewo przechodzone jest bez stosu raz
+** dla kazdej grupy (wezla z co najwyzej GROUP_SIZE cialami): wezel daleki od calej grupy
+** dziala jak punkt w srodku masy, cialo liscia blisko grupy dziala bezposrednio, a
+** pozostale wezly sa otwierane; zebrana lista oddzialywan sumowana jest dla wszystkich
+** cial grupy naraz rejestrami SIMD
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::computeAccelerations()
+{
+	const int nodeCount = static_cast<int>(nodes.size());
+	const float softening2 = softening * softening;
+
+	// grupy to wezly z co najwyzej GROUP_SIZE cialami, a liscie najglebszego poziomu z
+	// wieksza liczba cial dzielone sa na kilka grup
+	groups.clear();
+	for (int i = 0; i < nodeCount;)
+	{
+		const OctreeNode& node = nodes[i];
+
+		if (node.count <= GROUP_SIZE || node.next == i + 1)
+		{
+			for (int first = node.first; first < node.first + node.count; first += GROUP_SIZE)
+				groups.push_back(glm::ivec2(first, glm::min(GROUP_SIZE, node.first + node.count - first)));
+			i = node.next;
+		}
+		else
+			i++;
+	}
+
+	const int groupCount = static_cast<int>(groups.size());
+	const SimdKernels* kernels = simdKernels();
+
+	#pragma omp parallel
+	{
+		std::vector<glm::vec4> interactions; // srodki masy wezlow i ciala dzialajace na grupe
+
+		#pragma omp for schedule(dynamic, 16)
+		for (int g = 0; g < groupCount; g++)
+		{
+			const int first = groups[g].x;
+			const int last = groups[g].x + groups[g].y;
+
+			// ciala grupy w ukladzie SoA, uzupelnione do GROUP_SIZE ostatnim cialem
+			float x[GROUP_SIZE], y[GROUP_SIZE], z[GROUP_SIZE];
+			float ax[GROUP_SIZE] = {}, ay[GROUP_SIZE] = {}, az[GROUP_SIZE] = {};
+
+			glm::vec3 lower(bodies[first]);
+			glm::vec3 upper(bodies[first]);
+			for (int k = 0; k < GROUP_SIZE; k++)
+			{
+				const glm::vec4& body = bodies[glm::min(first + k, last - 1)];
+				x[k] = body.x;
+				y[k] = body.y;
+				z[k] = body.z;
+				lower = glm::min(lower, glm::vec3(body));
+				upper = glm::max(upper, glm::vec3(body));
+			}
+
+			const glm::vec3 center = 0.5f * (lower + upper);
+			const float radius = 0.5f * glm::length(upper - lower);
+
+			interactions.clear();
+			for (int i = 0; i < nodeCount;)
+			{
+				const OctreeNode& node = nodes[i];
+				const bool overlaps = node.first < last && first < node.first + node.count;
+				const float distance = glm::length(glm::vec3(node.centerOfMass) - center) - radius;
+
+				if (!overlaps && distance > 0.0f && distance * distance > node.openDistance2)
+				{
+					interactions.push_back(node.centerOfMass);
+					i = node.next;
+				}
+				else if (node.next == i + 1) // lisc - cialo grupy dziala samo na siebie z sila 0 (d = 0)
+				{
+					interactions.insert(interactions.end(), bodies.begin() + node.first, bodies.begin() + node.first + node.count);
+					i = node.next;
+				}
+				else
+					i++;
+			}
+
+			accumulateGroup(kernels, interactions.data(), static_cast<int>(interactions.size()), x, y, z, softening2, ax, ay, az);
+
+			for (int k = 0; k < last - first; k++)
+				accelerations[first + k] = gravity * glm::vec3(ax[k], ay[k], az[k]);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zeruje liczniki czasu budowy drzewa i przejsc drzewa
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::resetStats()
+{
+	steps = 0;
+	buildMs = 0.0;
+	forceMs = 0.0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyswietla sredni czas budowy drzewa i przejsc drzewa na krok
+** label - opis wyswietlany przed wynikami
+**------------------------------------------------------------------------------------------*/
+void NBodySimulation::printStats(const char* label) const
+{
+	const double perStep = (steps > 0) ? 1.0 / steps : 0.0;
+
+	std::cout << label << ": " << size() << " cial, " << nodes.size() << " wezlow, " << steps << " krokow, budowa drzewa "
+		<< buildMs * perStep << " ms, przyspieszenia (" << simdName() << ") " << forceMs * perStep << " ms na krok" << std::endl;
+}
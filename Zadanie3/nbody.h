@@ -0,0 +1,77 @@
+#ifndef __NBODY_H__
+#define __NBODY_H__
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+/*------------------------------------------------------------------------------------------
+** wezel drzewa osemkowego Barnesa-Huta - wezly zapisane sa w kolejnosci przejscia w glab,
+** wiec pierwsze dziecko wezla i ma indeks i + 1, a next wskazuje wezel za jego poddrzewem
+** (lisc ma next == i + 1); ciala poddrzewa zajmuja ciagly przedzial [first, first + count)
+**------------------------------------------------------------------------------------------*/
+struct OctreeNode
+{
+	glm::vec4 centerOfMass; // srodek masy (xyz) i masa (w) poddrzewa
+	float openDistance2; // kwadrat odleglosci, ponizej ktorej wezel jest otwierany (size / theta)^2
+	int first; // pierwsze cialo poddrzewa
+	int count; // liczba cial poddrzewa
+	int next; // wezel za poddrzewem
+};
+
+/*------------------------------------------------------------------------------------------
+** symulacja grawitacji N cial metoda Barnesa-Huta - drzewo osemkowe budowane jest w kazdym
+** kroku od nowa z cial posortowanych wedlug kodu Mortona (kolejnosc Z), a ciala
+** przestawiane sa w tej kolejnosci, wiec bliskie ciala leza obok siebie w pamieci;
+** przyspieszenia liczone sa rownolegle przez wiele watkow, a polozenia i predkosci
+** calkowane symplektyczna metoda leapfrog (kick-drift-kick)
+**------------------------------------------------------------------------------------------*/
+struct NBodySimulation
+{
+	static const int LEAF_SIZE = 8; // maksymalna liczba cial liscia (wieksze liscie tylko na najglebszym poziomie)
+	static const int MORTON_BITS = 21; // bity kodu Mortona na os (glebokosc drzewa)
+	static const int GROUP_SIZE = 16; // maksymalna liczba cial grupy przechodzacej drzewo wspolnie (wielokrotnosc szerokosci rejestru SIMD)
+
+	float gravity = 1.0f; // stala grawitacji
+	float softening = 0.01f; // odleglosc wygladzania sily przy zblizeniach cial
+	float theta = 0.6f; // kryterium otwarcia wezla (rozmiar / odleglosc)
+
+	std::vector<glm::vec4> bodies; // polozenie (xyz) i masa (w) ciala
+	std::vector<glm::vec3> velocities;
+	std::vector<glm::vec3> accelerations;
+	std::vector<int> ids; // numer ciala nadany przez addBody (np. indeks jego koloru)
+	std::vector<OctreeNode> nodes;
+
+	double time = 0.0; // czas symulacji
+	long long steps = 0; // liczba krokow od resetStats
+	double buildMs = 0.0; // laczny czas budowy drzewa (sortowanie i wezly)
+	double forceMs = 0.0; // laczny czas przejsc drzewa (przyspieszenia)
+
+	// bufory pomocnicze sortowania (przechowywane miedzy krokami, aby nie alokowac pamieci)
+	std::vector<std::uint64_t> codes; // kody Mortona cial
+	std::vector<std::uint64_t> sortedCodes;
+	std::vector<int> order; // indeksy cial w kolejnosci kodow Mortona
+	std::vector<int> sortedOrder;
+	std::vector<glm::vec4> sortedBodies;
+	std::vector<glm::vec3> sortedVelocities;
+	std::vector<int> sortedIds;
+	std::vector<glm::ivec2> groups; // grupy cial przechodzacych drzewo wspolnie (pierwsze cialo, liczba cial)
+	float rootSize = 0.0f; // krawedz szescianu otaczajacego ciala
+
+	int size() const { return static_cast<int>(bodies.size()); }
+
+	void clear();
+	void reserve(int capacity);
+	void addBody(const glm::vec3& position, const glm::vec3& velocity, float mass);
+	void start();
+	void step(float dt);
+	void buildTree();
+	void computeAccelerations();
+	void resetStats();
+	void printStats(const char* label) const;
+	void sortBodies();
+	int buildNode(int first, int last, int level, float size);
+};
+
+#endif /* __NBODY_H__ */
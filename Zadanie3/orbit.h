@@ -0,0 +1,67 @@
+#ifndef __ORBIT_H__
+#define __ORBIT_H__
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <cmath>
+
+const int KEPLER_ITERATIONS = 5; // liczba iteracji metody Newtona dla rownania Keplera
+
+/*------------------------------------------------------------------------------------------
+** orbita obiektu wzgledem obiektu nadrzednego w plaszczyznie xy jego ukladu wspolrzednych
+** (elementy orbitalne keplerowskie; eccentricity = 0 oznacza orbite kolowa)
+**------------------------------------------------------------------------------------------*/
+struct Orbit
+{
+	float semiMajorAxis; // polos wielka
+	float eccentricity; // mimosrod (0 <= e < 1)
+	float meanMotion; // predkosc katowa ruchu sredniego w radianach na sekunde (ujemna - ruch wsteczny)
+	float meanAnomaly; // anomalia srednia w chwili t = 0
+	float periapsis; // argument perycentrum
+};
+
+/*------------------------------------------------------------------------------------------
+** polozenie obiektu na orbicie - kat mierzony od osi x ukladu obiektu nadrzednego oraz
+** odleglosc od niego
+**------------------------------------------------------------------------------------------*/
+struct OrbitState
+{
+	float angle;
+	float radius;
+};
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza polozenie obiektu na orbicie w dowolnej chwili t bez calkowania krok po
+** kroku; anomalia srednia liczona jest w podwojnej precyzji i sprowadzana do [0, 2pi),
+** wiec wynik nie traci dokladnosci dla duzych t
+** orbit - elementy orbity
+** t - czas w sekundach
+**------------------------------------------------------------------------------------------*/
+inline OrbitState evaluateOrbit(const Orbit& orbit, double t)
+{
+	const double TWO_PI = glm::two_pi<double>();
+
+	double m = std::fmod(orbit.meanAnomaly + orbit.meanMotion * t, TWO_PI);
+	if (m < 0.0)
+		m += TWO_PI;
+
+	const float meanAnomaly = static_cast<float>(m);
+	const float e = orbit.eccentricity;
+
+	if (e == 0.0f) // orbita kolowa - anomalia prawdziwa rowna jest sredniej
+		return { orbit.periapsis + meanAnomaly, orbit.semiMajorAxis };
+
+	// rownanie Keplera M = E - e sin E rozwiazywane stala liczba iteracji Newtona
+	// (bez warunku stopu, wiec petla dla wielu obiektow nie rozgalezia sie)
+	float eccentricAnomaly = meanAnomaly + e * std::sin(meanAnomaly);
+	for (int i = 0; i < KEPLER_ITERATIONS; i++)
+		eccentricAnomaly -= (eccentricAnomaly - e * std::sin(eccentricAnomaly) - meanAnomaly) / (1.0f - e * std::cos(eccentricAnomaly));
+
+	const float trueAnomaly = 2.0f * std::atan2(std::sqrt(1.0f + e) * std::sin(0.5f * eccentricAnomaly),
+		std::sqrt(1.0f - e) * std::cos(0.5f * eccentricAnomaly));
+
+	return { orbit.periapsis + trueAnomaly, orbit.semiMajorAxis * (1.0f - e * std::cos(eccentricAnomaly)) };
+}
+
+#endif /* __ORBIT_H__ */
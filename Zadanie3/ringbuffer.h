@@ -0,0 +1,43 @@
+#ifndef __RINGBUFFER_H__
+#define __RINGBUFFER_H__
+
+#include <GL/glew.h>
+
+/*------------------------------------------------------------------------------------------
+** bufor strumieniowy dla danych zmieniajacych sie co klatke - podzielony na REGION_COUNT
+** regionow, z ktorych kazda klatka zapisuje do kolejnego; przed ponownym uzyciem regionu
+** CPU czeka na plot (glFenceSync) wstawiony po rysowaniu, ktore z niego czytalo
+** z ARB_buffer_storage bufor jest zmapowany trwale (GL_MAP_PERSISTENT_BIT |
+** GL_MAP_COHERENT_BIT) i dane zapisywane sa bez zadnych kopii po stronie sterownika;
+** bez rozszerzenia region mapowany jest co klatke z GL_MAP_UNSYNCHRONIZED_BIT
+**------------------------------------------------------------------------------------------*/
+struct RingBuffer
+{
+	static const int REGION_COUNT = 3; // potrojne buforowanie
+
+	GLenum target = GL_UNIFORM_BUFFER;
+	GLuint buffer = 0;
+	GLsizeiptr regionSize = 0;
+	GLsizeiptr alignment = 1; // wyrownanie poczatku kazdej alokacji
+	bool persistent = false; // czy bufor jest trwale zmapowany
+
+	unsigned char* mapped = nullptr; // trwale zmapowana pamiec calego bufora
+	GLsync fences[REGION_COUNT] = {};
+	int region = 0; // region zapisywany w biezacej klatce
+	GLsizeiptr used = 0; // zajeta czesc biezacego regionu
+
+	long long frames = 0; // liczba klatek
+	long long stalls = 0; // liczba klatek, w ktorych CPU czekalo na zwolnienie regionu przez GPU
+	double stallMs = 0.0; // laczny czas oczekiwania
+
+	void init(GLenum bufferTarget, GLsizeiptr bufferRegionSize, GLsizeiptr bufferAlignment, bool allowPersistent);
+	void destroy();
+	void beginFrame();
+	void* map(GLsizeiptr size, GLintptr& offset);
+	void unmap();
+	void endFrame();
+	void resetStats();
+	void printStats(const char* label) const;
+};
+
+#endif /* __RINGBUFFER_H__ */
@@ -0,0 +1,135 @@
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#include "scene.h"
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa wszystkie wezly
+**------------------------------------------------------------------------------------------*/
+void SceneGraph::clear()
+{
+	parents.clear();
+	orbits.clear();
+	locals.clear();
+	scales.clear();
+	worldMatrices.clear();
+	rangeStarts.clear();
+	boundRadii.clear();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rezerwuje miejsce na capacity wezlow
+**------------------------------------------------------------------------------------------*/
+void SceneGraph::reserve(int capacity)
+{
+	parents.reserve(capacity);
+	orbits.reserve(capacity);
+	locals.reserve(capacity);
+	scales.reserve(capacity);
+	worldMatrices.reserve(capacity);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja dodaje wezel na koncu tablic i zwraca jego indeks
+** parent - indeks rodzica (dodanego wczesniej) lub -1 dla korzenia
+** orbit - orbita wezla wzgledem rodzica
+** scale - skala samego wezla
+**------------------------------------------------------------------------------------------*/
+int SceneGraph::addNode(int parent, const Orbit& orbit, float scale)
+{
+	assert(parent < size()); // rodzic przed dzieckiem - warunek jednego przejscia w updateWorldMatrices
+
+	if (rangeStarts.empty() || parent >= rangeStarts.back()) // rodzic w biezacym przedziale
+		rangeStarts.push_back(size());
+
+	parents.push_back(parent);
+	orbits.push_back(orbit);
+	locals.push(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+	scales.push_back(scale);
+	worldMatrices.push_back(glm::mat4(1.0f));
+
+	return size() - 1;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza lokalne przesuniecia i obroty wezlow z ich orbit w chwili t - uklad
+** wezla obraca sie wokol osi z rodzica o kat polozenia na orbicie
+** t - czas w sekundach
+**------------------------------------------------------------------------------------------*/
+void SceneGraph::updateOrbits(double t)
+{
+	const int count = size();
+
+	#pragma omp parallel for if (count > 4096)
+	for (int i = 0; i < count; i++)
+	{
+		const OrbitState state = evaluateOrbit(orbits[i], t);
+		const float c = std::cos(state.angle);
+		const float s = std::sin(state.angle);
+
+		locals.set(i, glm::vec3(state.radius * c, state.radius * s, 0.0f), glm::quat(std::cos(0.5f * state.angle), 0.0f, 0.0f, std::sin(0.5f * state.angle)));
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza macierze swiata wszystkich wezlow - dzieki kolejnosci topologicznej
+** macierz rodzica jest juz policzona, gdy potrzebuje jej dziecko; przedzialy liczone sa
+** po kolei, a kazdy z nich dzielony jest na fragmenty dla kolejnych watkow
+**------------------------------------------------------------------------------------------*/
+void SceneGraph::updateWorldMatrices()
+{
+	const int CHUNK = 4096; // liczba wezlow liczonych przez watek naraz
+
+	for (size_t range = 0; range < rangeStarts.size(); range++)
+	{
+		const int first = rangeStarts[range];
+		const int last = (range + 1 < rangeStarts.size()) ? rangeStarts[range + 1] : size();
+		const int chunks = (last - first + CHUNK - 1) / CHUNK;
+
+		#pragma omp parallel for if (chunks > 1)
+		for (int chunk = 0; chunk < chunks; chunk++)
+		{
+			const int begin = first + chunk * CHUNK;
+			composeWorldMatrices(locals, parents.data(), begin, std::min(CHUNK, last - begin), worldMatrices.data());
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza promienie sfer otaczajacych poddrzewa - wezel oddala sie od rodzica
+** co najwyzej na odleglosc aphelium orbity a(1 + e), a przesuniecia i obroty nie zmieniaja
+** odleglosci, wiec sfera o srodku w wezle jest stala w czasie i liczona jest raz, od lisci
+** do korzeni
+** meshRadius - promien siatki obiektu przed skalowaniem
+**------------------------------------------------------------------------------------------*/
+void SceneGraph::updateBounds(float meshRadius)
+{
+	const int count = size();
+
+	boundRadii.resize(count);
+	for (int i = 0; i < count; i++)
+		boundRadii[i] = scales[i] * meshRadius;
+
+	for (int i = count - 1; i >= 0; i--)
+	{
+		if (parents[i] >= 0)
+		{
+			const float reach = orbits[i].semiMajorAxis * (1.0f + orbits[i].eccentricity) + boundRadii[i];
+			boundRadii[parents[i]] = std::max(boundRadii[parents[i]], reach);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca macierz modelu wezla - uklad wezla wraz z jego skala
+**------------------------------------------------------------------------------------------*/
+glm::mat4 SceneGraph::modelMatrix(int node) const
+{
+	glm::mat4 model = worldMatrices[node];
+	model[0] *= scales[node];
+	model[1] *= scales[node];
+	model[2] *= scales[node];
+
+	return model;
+}
@@ -0,0 +1,41 @@
+#ifndef __SCENE_H__
+#define __SCENE_H__
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "orbit.h"
+#include "transform.h"
+
+/*------------------------------------------------------------------------------------------
+** hierarchia obiektow sceny zapisana jako struktura tablic - wezel i to i-ty element
+** kazdej z tablic; rodzic wezla ma zawsze mniejszy indeks (kolejnosc topologiczna), wiec
+** macierze swiata wszystkich wezlow liczone sa jednym liniowym przejsciem; kolejne wezly,
+** ktorych rodzice leza przed nimi (np. jeden poziom drzewa), tworza przedzial liczony
+** rownolegle przez wiele watkow
+** przesuniecie i obrot sa dziedziczone przez potomkow, a skala dotyczy tylko samego
+** wezla (np. rozmiar planety nie zmienia promienia orbity jej ksiezyca)
+**------------------------------------------------------------------------------------------*/
+struct SceneGraph
+{
+	std::vector<int> parents; // indeks rodzica (-1 - korzen)
+	std::vector<Orbit> orbits; // ruch wezla wzgledem rodzica
+	TransformArrays locals; // lokalne przesuniecie i obrot wzgledem rodzica
+	std::vector<float> scales; // skala samego wezla (niedziedziczona)
+	std::vector<glm::mat4> worldMatrices; // uklad wezla w przestrzeni swiata (bez skali)
+	std::vector<int> rangeStarts; // poczatki przedzialow wezlow niezaleznych od siebie nawzajem
+	std::vector<float> boundRadii; // promien sfery wokol wezla obejmujacej jego siatke i cale poddrzewo (updateBounds)
+
+	int size() const { return static_cast<int>(parents.size()); }
+
+	void clear();
+	void reserve(int capacity);
+	int addNode(int parent, const Orbit& orbit, float scale);
+	void updateOrbits(double t);
+	void updateWorldMatrices();
+	void updateBounds(float meshRadius);
+	glm::mat4 modelMatrix(int node) const;
+};
+
+#endif /* __SCENE_H__ */
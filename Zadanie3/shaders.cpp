@@ -1,6 +1,7 @@
 #include <GL/glew.h>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #include "shaders.h"
 
@@ -119,53 +120,80 @@ void printProgramInfoLog(GLuint program)
 }
 
 /*------------------------------------------------------------------------------------------
-** funkcja tworzaca program cieniowania skladajacy sie z shadera wierzcholkow i fragmentow
-** vertexShaderFilename - nazwa pliku z kodem zrodlowym shadera wierzcholkow
-** fragmentShaderFilename - nazwa pliku z kodem zrodlowym shadera fragmentow
+** funkcja tworzaca program cieniowania z dowolnego zestawu shaderow
+** files - nazwy plikow z kodem zrodlowym shaderow wraz z ich typami
 ** shaderProgram - referencja na identyfikator tworzonego w funkcji programu
 ** funkcja zwraca true jesli powiedzie sie tworzenie programu cieniowania
 **------------------------------------------------------------------------------------------*/
-bool setupShaders(std::string vertexShaderFilename, std::string fragmentShaderFilename, GLuint& shaderProgram)
+bool setupProgram(const std::vector<ShaderFile>& files, GLuint& shaderProgram)
 {
 	shaderProgram = glCreateProgram(); // utworzenie identyfikatora programu cieniowania
 
-	GLuint vertexShader;
-	if (!createShader(vertexShaderFilename, GL_VERTEX_SHADER, vertexShader))
+	std::vector<GLuint> shaders;
+	std::string names;
+
+	for (const ShaderFile& file : files)
 	{
-		glDeleteShader(vertexShader);
-		glDeleteProgram(shaderProgram);
+		GLuint shader;
+		bool created = createShader(file.filename, file.type, shader);
 
-		return false;
-	}
+		shaders.push_back(shader);
+		names += (names.empty() ? "" : ", ") + file.filename;
 
-	GLuint fragmentShader;
-	if (!createShader(fragmentShaderFilename, GL_FRAGMENT_SHADER, fragmentShader))
-	{
-		glDeleteShader(vertexShader);
-		glDeleteShader(fragmentShader);
-		glDeleteProgram(shaderProgram);
+		if (!created)
+		{
+			for (GLuint s : shaders)
+				glDeleteShader(s);
+			glDeleteProgram(shaderProgram);
 
-		return false;
-	}
+			return false;
+		}
 
-	glAttachShader(shaderProgram, vertexShader); // dolaczenie shadera wierzcholkow
-	glAttachShader(shaderProgram, fragmentShader); // dolaczenie shadera fragmentow
+		glAttachShader(shaderProgram, shader); // dolaczenie shadera
+	}
 
 	glLinkProgram(shaderProgram); // linkowanie programu cieniowania
 
+	for (GLuint shader : shaders)
+		glDeleteShader(shader); // shadery zostana usuniete razem z programem
+
 	GLint linkStatus;
 	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &linkStatus);
 	if (linkStatus == 0)
 	{
-		std::cerr << "Blad przy linkowaniu programu cieniowania (" << vertexShaderFilename.c_str() << ", " << fragmentShaderFilename.c_str() << ")\n";
+		std::cerr << "Blad przy linkowaniu programu cieniowania (" << names.c_str() << ")\n";
 		printProgramInfoLog(shaderProgram); // wyswietlenie logu linkowania
 
-		glDeleteShader(vertexShader);
-		glDeleteShader(fragmentShader);
 		glDeleteProgram(shaderProgram);
 
 		return false;
 	}
 
 	return true;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzaca program cieniowania skladajacy sie z shadera wierzcholkow i fragmentow
+** vertexShaderFilename - nazwa pliku z kodem zrodlowym shadera wierzcholkow
+** fragmentShaderFilename - nazwa pliku z kodem zrodlowym shadera fragmentow
+** shaderProgram - referencja na identyfikator tworzonego w funkcji programu
+** funkcja zwraca true jesli powiedzie sie tworzenie programu cieniowania
+**------------------------------------------------------------------------------------------*/
+bool setupShaders(std::string vertexShaderFilename, std::string fragmentShaderFilename, GLuint& shaderProgram)
+{
+	return setupProgram({ { vertexShaderFilename, GL_VERTEX_SHADER }, { fragmentShaderFilename, GL_FRAGMENT_SHADER } }, shaderProgram);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja tworzaca program cieniowania skladajacy sie z shadera wierzcholkow, geometrii
+** i fragmentow
+** vertexShaderFilename - nazwa pliku z kodem zrodlowym shadera wierzcholkow
+** geometryShaderFilename - nazwa pliku z kodem zrodlowym shadera geometrii
+** fragmentShaderFilename - nazwa pliku z kodem zrodlowym shadera fragmentow
+** shaderProgram - referencja na identyfikator tworzonego w funkcji programu
+** funkcja zwraca true jesli powiedzie sie tworzenie programu cieniowania
+**------------------------------------------------------------------------------------------*/
+bool setupShaders(std::string vertexShaderFilename, std::string geometryShaderFilename, std::string fragmentShaderFilename, GLuint& shaderProgram)
+{
+	return setupProgram({ { vertexShaderFilename, GL_VERTEX_SHADER }, { geometryShaderFilename, GL_GEOMETRY_SHADER }, { fragmentShaderFilename, GL_FRAGMENT_SHADER } }, shaderProgram);
 }
\ No newline at end of file
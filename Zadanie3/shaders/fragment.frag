@@ -1,6 +1,12 @@
 #version 330
- 
-uniform vec4 color; // kolor obiektu
+
+// dane obiektu - fragment bufora UBO wybierany przez glBindBufferRange
+layout(std140) uniform ObjectBlock
+{
+	mat4 mvpMatrix;
+	vec4 color; // kolor obiektu
+	vec4 fillColor;
+};
 
 out vec4 fColor;
  
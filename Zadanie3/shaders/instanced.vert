@@ -0,0 +1,21 @@
+#version 330
+
+// dane wspolne dla calej klatki
+layout(std140) uniform FrameBlock
+{
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+	float lineWidth; // grubosc krawedzi w pikselach
+};
+
+layout(location = 0) in vec4 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
+layout(location = 1) in mat4x3 iModelMatrix; // macierz modelu instancji bez ostatniego wiersza (lokalizacje 1-4)
+layout(location = 5) in vec4 iColor; // kolor instancji
+
+flat out vec4 vColor;
+
+void main()
+{
+	gl_Position = projectionMatrix * viewMatrix * vec4(iModelMatrix * vPosition, 1.0);
+	vColor = iColor;
+}
\ No newline at end of file
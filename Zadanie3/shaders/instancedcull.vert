@@ -0,0 +1,46 @@
+#version 430
+
+// dane wspolne dla calej klatki
+layout(std140) uniform FrameBlock
+{
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+	float lineWidth; // grubosc krawedzi w pikselach
+};
+
+// dane obiektu - uklad jak GpuBody
+struct Body
+{
+	float semiMajorAxis;
+	float eccentricity;
+	float meanMotion;
+	float meanAnomaly;
+	float periapsis;
+	int parent;
+	float scale;
+	uint color;
+};
+
+layout(std430, binding = 1) readonly buffer BodyData
+{
+	Body bodies[];
+};
+
+// macierze swiata wyznaczone przez transforms.comp (obiekty wybrane przez cull.comp)
+layout(std430, binding = 2) readonly buffer WorldMatrices
+{
+	mat4 worldMatrices[];
+};
+
+layout(location = 0) in vec4 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
+layout(location = 1) in uint objectIndex; // indeks obiektu z przedzialu poziomu szczegolowosci (atrybut instancji)
+
+flat out vec4 vColor;
+
+void main()
+{
+	Body body = bodies[objectIndex];
+
+	gl_Position = projectionMatrix * viewMatrix * worldMatrices[objectIndex] * vec4(body.scale * vPosition.xyz, 1.0);
+	vColor = unpackUnorm4x8(body.color);
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#version 430
+
+// dane wspolne dla calej klatki
+layout(std140) uniform FrameBlock
+{
+	mat4 projectionMatrix;
+	mat4 viewMatrix;
+	float lineWidth; // grubosc krawedzi w pikselach
+};
+
+// dane obiektu - uklad jak GpuBody
+struct Body
+{
+	float semiMajorAxis;
+	float eccentricity;
+	float meanMotion;
+	float meanAnomaly;
+	float periapsis;
+	int parent;
+	float scale;
+	uint color;
+};
+
+layout(std430, binding = 1) readonly buffer BodyData
+{
+	Body bodies[];
+};
+
+// macierze swiata wyznaczone przez transforms.comp
+layout(std430, binding = 2) readonly buffer WorldMatrices
+{
+	mat4 worldMatrices[];
+};
+
+layout(location = 0) in vec4 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
+
+flat out vec4 vColor;
+
+void main()
+{
+	Body body = bodies[gl_InstanceID];
+
+	gl_Position = projectionMatrix * viewMatrix * worldMatrices[gl_InstanceID] * vec4(body.scale * vPosition.xyz, 1.0);
+	vColor = unpackUnorm4x8(body.color);
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#version 430
+#extension GL_ARB_shader_draw_parameters : require
+
+// dane obiektu - uklad jak ObjectBlock
+struct ObjectData
+{
+	mat4 mvpMatrix; // iloczyn macierzy projekcji i model-widok
+	vec4 color;
+	vec4 fillColor;
+};
+
+// dane wszystkich obiektow klatki, indeksowane numerem rysowania w glMultiDrawElementsIndirect
+layout(std430, binding = 0) readonly buffer DrawData
+{
+	ObjectData objects[];
+};
+
+layout(location = 0) in vec4 vPosition; // pozycja wierzcholka w lokalnym ukladzie wspolrzednych
+
+flat out vec4 vColor;
+
+void main()
+{
+	ObjectData object = objects[gl_DrawIDARB];
+
+	gl_Position = object.mvpMatrix * vPosition;
+	vColor = object.color;
+}
\ No newline at end of file
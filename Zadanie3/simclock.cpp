@@ -0,0 +1,54 @@
+#include "simclock.h"
+
+/*------------------------------------------------------------------------------------------
+** funkcja zeruje zegar - czas symulacji liczony jest od tej chwili
+**------------------------------------------------------------------------------------------*/
+void SimulationClock::start()
+{
+	accumulator = 0.0;
+	time = 0.0;
+	steps = 0;
+	last = std::chrono::steady_clock::now();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja dodaje do akumulatora czas, ktory uplynal od poprzedniej klatki, i zwraca liczbe
+** krokow symulacji do wykonania w biezacej klatce
+**------------------------------------------------------------------------------------------*/
+int SimulationClock::advance()
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	double frameTime = virtualTime ? step : std::chrono::duration<double>(now - last).count();
+	last = now;
+
+	if (frameTime > maxFrameTime)
+		frameTime = maxFrameTime;
+
+	if (paused)
+		frameTime = 0.0;
+
+	accumulator += frameTime;
+
+	int count = 0;
+	while (accumulator >= step)
+	{
+		accumulator -= step;
+		count++;
+	}
+
+	time += count * step;
+	steps += count;
+
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja przestawia czas symulacji (przewijanie) - stan wyznaczany jest na nowo dla
+** chwili t, wiec zmiana nie wymaga symulowania krokow posrednich
+** t - nowy czas symulacji w sekundach
+**------------------------------------------------------------------------------------------*/
+void SimulationClock::seek(double t)
+{
+	time = t;
+	accumulator = 0.0;
+}
@@ -0,0 +1,33 @@
+#ifndef __SIMCLOCK_H__
+#define __SIMCLOCK_H__
+
+#include <chrono>
+
+/*------------------------------------------------------------------------------------------
+** zegar symulacji ze stalym krokiem - czas rzeczywisty (lub wirtualny) miedzy klatkami
+** gromadzony jest w akumulatorze, a symulacja wykonuje tyle krokow o dlugosci step, ile
+** sie w nim miesci; orbity rysowane sa w chwili now() (wlacznie z reszta akumulatora),
+** a ciala N-body w stanie po ostatnim wykonanym kroku (bez interpolacji)
+** w trybie wirtualnym kazda klatka trwa dokladnie jeden krok, niezaleznie od tego jak
+** szybko jest rysowana, wiec kolejne klatki pokazuja zawsze ta sama scene
+**------------------------------------------------------------------------------------------*/
+struct SimulationClock
+{
+	double step = 1.0 / 60.0; // dlugosc kroku symulacji w sekundach
+	double maxFrameTime = 0.25; // ograniczenie czasu klatki (np. po zatrzymaniu w debuggerze)
+	bool virtualTime = false; // czy kazda klatka trwa dokladnie jeden krok
+	bool paused = false; // czy czas symulacji jest zatrzymany
+
+	double accumulator = 0.0; // czas jeszcze nie zasymulowany
+	double time = 0.0; // czas symulacji
+	long long steps = 0; // liczba wykonanych krokow
+
+	std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+
+	void start();
+	int advance();
+	void seek(double t);
+	double now() const { return time + accumulator; } // czas symulacji w chwili rysowania klatki
+};
+
+#endif /* __SIMCLOCK_H__ */
@@ -0,0 +1,140 @@
+#include "simd.h"
+
+#if defined(SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(SIMD_X86)
+#include <cpuid.h>
+#endif
+
+static SimdLevel simdLimit = SIMD_AVX512; // najwyzszy zestaw dopuszczony przez setSimdLimit
+
+#if defined(SIMD_X86)
+/*------------------------------------------------------------------------------------------
+** funkcja wykonuje instrukcje cpuid
+** regs - rejestry eax, ebx, ecx, edx
+**------------------------------------------------------------------------------------------*/
+static void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+	int values[4];
+	__cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+
+	for (int i = 0; i < 4; i++)
+		regs[i] = static_cast<unsigned int>(values[i]);
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja odczytuje rejestr XCR0 - stany rejestrow zachowywane przez system operacyjny
+** przy przelaczaniu watkow
+**------------------------------------------------------------------------------------------*/
+static unsigned long long readXcr0()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int low, high;
+	__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+
+	return (static_cast<unsigned long long>(high) << 32) | low;
+#endif
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja sprawdza obsluge zestawow instrukcji przez procesor i system operacyjny (AVX
+** wymaga zachowywania rejestrow ymm, a AVX-512 dodatkowo zmm i rejestrow masek)
+**------------------------------------------------------------------------------------------*/
+static SimdLevel querySimdLevel()
+{
+	unsigned int regs[4];
+
+	cpuid(0, 0, regs);
+	const unsigned int maxLeaf = regs[0];
+
+	cpuid(1, 0, regs);
+	const bool sse2 = (regs[3] >> 26 & 1) != 0;
+	const bool osxsave = (regs[2] >> 27 & 1) != 0;
+	const bool avx = (regs[2] >> 28 & 1) != 0;
+	const bool fma = (regs[2] >> 12 & 1) != 0;
+
+	if (!sse2)
+		return SIMD_NONE;
+	if (!osxsave || !avx || !fma || maxLeaf < 7)
+		return SIMD_SSE2;
+
+	const unsigned long long xcr0 = readXcr0();
+	if ((xcr0 & 0x6) != 0x6) // stany xmm i ymm
+		return SIMD_SSE2;
+
+	cpuid(7, 0, regs);
+	const bool avx2 = (regs[1] >> 5 & 1) != 0;
+	const bool avx512 = (regs[1] >> 16 & 1) != 0;
+
+	if (!avx2)
+		return SIMD_SSE2;
+	if (!avx512 || (xcr0 & 0xE0) != 0xE0) // stany opmask, zmm0-15 (gorne polowy) i zmm16-31
+		return SIMD_AVX2;
+
+	return SIMD_AVX512;
+}
+#endif
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca najwyzszy zestaw instrukcji obslugiwany przez procesor (sprawdzany raz)
+**------------------------------------------------------------------------------------------*/
+SimdLevel detectSimdLevel()
+{
+#if defined(SIMD_X86)
+	static const SimdLevel level = querySimdLevel();
+	return level;
+#else
+	return SIMD_NONE;
+#endif
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja ogranicza zestaw instrukcji wybierany przez simdKernels (np. w celu porownania
+** jader roznych zestawow); nie nalezy jej wywolywac podczas obliczen w innych watkach
+**------------------------------------------------------------------------------------------*/
+void setSimdLimit(SimdLevel level)
+{
+	simdLimit = level;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca jadra najszerszego zestawu instrukcji obslugiwanego przez procesor i
+** dopuszczonego przez setSimdLimit (nullptr - brak SIMD, obliczenia skalarne)
+**------------------------------------------------------------------------------------------*/
+const SimdKernels* simdKernels()
+{
+	const SimdLevel detected = detectSimdLevel();
+	const SimdLevel level = (detected < simdLimit) ? detected : simdLimit;
+
+	switch (level)
+	{
+#if defined(SIMD_X86)
+	case SIMD_AVX512:
+		return &AVX512_KERNELS;
+
+	case SIMD_AVX2:
+		return &AVX2_KERNELS;
+
+	case SIMD_SSE2:
+		return &SSE2_KERNELS;
+#endif
+
+	default:
+		return nullptr;
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca nazwe zestawu instrukcji wybranego przez simdKernels
+**------------------------------------------------------------------------------------------*/
+const char* simdName()
+{
+	const SimdKernels* kernels = simdKernels();
+	return kernels ? kernels->name : "brak SIMD";
+}
@@ -0,0 +1,68 @@
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+// jadra SIMD kompilowane sa tylko dla procesorow x86 (simdsse2.cpp, simdavx2.cpp, simdavx512.cpp)
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_X86
+#endif
+
+#include <cstdint>
+
+// zestawy instrukcji w kolejnosci rosnacej szerokosci rejestrow
+enum SimdLevel { SIMD_NONE, SIMD_SSE2, SIMD_AVX2, SIMD_AVX512 };
+
+// wynik testu sfery z ostroslupem widzenia
+enum CullResult : std::uint8_t { CULL_OUTSIDE, CULL_INTERSECT, CULL_INSIDE };
+
+/*------------------------------------------------------------------------------------------
+** lokalne przesuniecia i obroty wezlow w ukladzie SoA (tablice TransformArrays) - jadra
+** SIMD nie wywoluja funkcji glm ani biblioteki standardowej, wiec ich pliki moga byc
+** kompilowane z innym zestawem instrukcji bez ryzyka, ze wspolne funkcje inline zostana
+** zastapione wersjami wymagajacymi np. AVX2
+**------------------------------------------------------------------------------------------*/
+struct LocalTransforms
+{
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* qx;
+	const float* qy;
+	const float* qz;
+	const float* qw;
+};
+
+/*------------------------------------------------------------------------------------------
+** jadra obliczen skompilowane dla jednego zestawu instrukcji - kazde przetwarza width
+** elementow (wezlow, cial, sfer) naraz; zestaw wybierany jest w czasie dzialania programu
+** wedlug mozliwosci procesora (simdKernels)
+**------------------------------------------------------------------------------------------*/
+struct SimdKernels
+{
+	SimdLevel level;
+	const char* name;
+	int width; // liczba elementow rejestru
+
+	// macierze swiata (16 liczb na wezel) width kolejnych wezlow od first (composeWorldMatrices)
+	void (*composeBlock)(const LocalTransforms& locals, const int* parents, int first, float* world);
+
+	// przyspieszenia groupSize cial (wielokrotnosc width) od count zrodel - polozen (xyz) i mas (w)
+	void (*accumulateGroup)(const float* sources, int count, int groupSize, const float* x, const float* y, const float* z, float softening2,
+		float* ax, float* ay, float* az);
+
+	// wyniki (CullResult) testu sfer z szescioma plaszczyznami (xyzw); zwraca liczbe
+	// przetestowanych sfer - count zaokraglone w dol do wielokrotnosci width
+	int (*testSphereBlocks)(const float* planes, const float* x, const float* y, const float* z, const float* radius, int count, std::uint8_t* results);
+};
+
+#if defined(SIMD_X86)
+extern const SimdKernels SSE2_KERNELS; // simdsse2.cpp
+extern const SimdKernels AVX2_KERNELS; // simdavx2.cpp (AVX2 i FMA)
+extern const SimdKernels AVX512_KERNELS; // simdavx512.cpp (AVX-512F)
+#endif
+
+SimdLevel detectSimdLevel();
+void setSimdLimit(SimdLevel level);
+const SimdKernels* simdKernels();
+const char* simdName();
+
+#endif /* __SIMD_H__ */
@@ -0,0 +1,50 @@
+#include "simd.h"
+
+#if defined(SIMD_X86)
+#include <immintrin.h>
+
+// plik kompilowany jest dla AVX2 i FMA (w projekcie Visual Studio opcja /arch:AVX2 tylko
+// dla tego pliku), a jego jadra wywolywane sa tylko na procesorach z tymi instrukcjami
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC target("avx2,fma")
+#endif
+
+#include "simdkernels.h"
+
+/*------------------------------------------------------------------------------------------
+** operacje na rejestrach AVX2 (8 elementow) z mnozeniem i dodawaniem FMA
+**------------------------------------------------------------------------------------------*/
+struct Avx2Lanes
+{
+	static const int WIDTH = 8;
+
+	typedef __m256 Reg;
+	typedef __m256i Index;
+
+	static Reg set1(float value) { return _mm256_set1_ps(value); }
+	static Reg load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, Reg a) { _mm256_storeu_ps(p, a); }
+	static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+	static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+	static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+	static Reg madd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+	static Reg rsqrtApprox(Reg a) { return _mm256_rsqrt_ps(a); }
+	static int lessMask(Reg a, Reg b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); } // maska bitowa elementow a < b
+	static Index index(const int* parents) { return _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(parents)), 4); }
+	static Reg gather(const float* base, Index index) { return _mm256_i32gather_ps(base, index, 4); }
+
+	static void storeColumns(float* out, Reg x, Reg y, Reg z, Reg w)
+	{
+		storeColumns4(out, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z), _mm256_castps256_ps128(w));
+		storeColumns4(out + 64, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1));
+	}
+};
+
+const SimdKernels AVX2_KERNELS = { SIMD_AVX2, "AVX2", Avx2Lanes::WIDTH, composeBlock<Avx2Lanes>, accumulateGroup<Avx2Lanes>, testSphereBlocks<Avx2Lanes> };
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
+#endif
@@ -0,0 +1,52 @@
+#include "simd.h"
+
+#if defined(SIMD_X86)
+#include <immintrin.h>
+
+// plik kompilowany jest dla AVX-512F (w projekcie Visual Studio opcja /arch:AVX512 tylko
+// dla tego pliku), a jego jadra wywolywane sa tylko na procesorach z tymi instrukcjami
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+
+#include "simdkernels.h"
+
+/*------------------------------------------------------------------------------------------
+** operacje na rejestrach AVX-512 (16 elementow)
+**------------------------------------------------------------------------------------------*/
+struct Avx512Lanes
+{
+	static const int WIDTH = 16;
+
+	typedef __m512 Reg;
+	typedef __m512i Index;
+
+	static Reg set1(float value) { return _mm512_set1_ps(value); }
+	static Reg load(const float* p) { return _mm512_loadu_ps(p); }
+	static void store(float* p, Reg a) { _mm512_storeu_ps(p, a); }
+	static Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+	static Reg sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+	static Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+	static Reg madd(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+	static Reg rsqrtApprox(Reg a) { return _mm512_rsqrt14_ps(a); }
+	static int lessMask(Reg a, Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); } // maska bitowa elementow a < b
+	static Index index(const int* parents) { return _mm512_slli_epi32(_mm512_loadu_si512(parents), 4); }
+	static Reg gather(const float* base, Index index) { return _mm512_i32gather_ps(index, base, 4); }
+
+	static void storeColumns(float* out, Reg x, Reg y, Reg z, Reg w)
+	{
+		storeColumns4(out, _mm512_extractf32x4_ps(x, 0), _mm512_extractf32x4_ps(y, 0), _mm512_extractf32x4_ps(z, 0), _mm512_extractf32x4_ps(w, 0));
+		storeColumns4(out + 64, _mm512_extractf32x4_ps(x, 1), _mm512_extractf32x4_ps(y, 1), _mm512_extractf32x4_ps(z, 1), _mm512_extractf32x4_ps(w, 1));
+		storeColumns4(out + 128, _mm512_extractf32x4_ps(x, 2), _mm512_extractf32x4_ps(y, 2), _mm512_extractf32x4_ps(z, 2), _mm512_extractf32x4_ps(w, 2));
+		storeColumns4(out + 192, _mm512_extractf32x4_ps(x, 3), _mm512_extractf32x4_ps(y, 3), _mm512_extractf32x4_ps(z, 3), _mm512_extractf32x4_ps(w, 3));
+	}
+};
+
+const SimdKernels AVX512_KERNELS = { SIMD_AVX512, "AVX-512", Avx512Lanes::WIDTH, composeBlock<Avx512Lanes>, accumulateGroup<Avx512Lanes>, testSphereBlocks<Avx512Lanes> };
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
+#endif
@@ -0,0 +1,181 @@
+#ifndef __SIMDKERNELS_H__
+#define __SIMDKERNELS_H__
+
+/*------------------------------------------------------------------------------------------
+** jadra obliczen wspolne dla wszystkich zestawow instrukcji - szablony parametryzowane
+** struktura Lanes z operacjami na rejestrach danego zestawu (kazdy element rejestru, WIDTH
+** elementow, to jeden wezel, cialo lub sfera); plik dolaczany jest tylko przez pliki
+** simdsse2.cpp, simdavx2.cpp i simdavx512.cpp po <immintrin.h> i dyrektywach wyboru
+** zestawu instrukcji, wiec nie moze dolaczac innych naglowkow
+**------------------------------------------------------------------------------------------*/
+
+#include "simd.h"
+
+/*------------------------------------------------------------------------------------------
+** funkcja zapisuje kolumne macierzy czterech kolejnych wezlow - rejestry zawieraja kolejne
+** skladowe (x, y, z, w) dla czterech wezlow i po transpozycji kazdy z nich to jedna
+** kolumna jednej macierzy
+** out - kolumna macierzy pierwszego wezla (kolejne co 16 liczb)
+**------------------------------------------------------------------------------------------*/
+static inline void storeColumns4(float* out, __m128 x, __m128 y, __m128 z, __m128 w)
+{
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+
+	_mm_storeu_ps(out, x);
+	_mm_storeu_ps(out + 16, y);
+	_mm_storeu_ps(out + 32, z);
+	_mm_storeu_ps(out + 48, w);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza macierze swiata Lanes::WIDTH kolejnych wezlow naraz - macierz obrotu
+** z kwaternionu i przesuniecie skladane sa od razu w rejestrach i mnozone przez macierze
+** rodzicow (wczytane instrukcja gather), bez zadnych macierzy posrednich w pamieci
+** rodzice wszystkich wezlow bloku musza byc juz policzeni (indeksy mniejsze niz first)
+** first - indeks pierwszego wezla bloku
+** world - macierze swiata wszystkich wezlow (16 liczb na wezel)
+**------------------------------------------------------------------------------------------*/
+template <typename Lanes>
+void composeBlock(const LocalTransforms& locals, const int* parents, int first, float* world)
+{
+	typedef typename Lanes::Reg Reg;
+
+	const Reg zero = Lanes::set1(0.0f);
+	const Reg one = Lanes::set1(1.0f);
+
+	const Reg qx = Lanes::load(locals.qx + first);
+	const Reg qy = Lanes::load(locals.qy + first);
+	const Reg qz = Lanes::load(locals.qz + first);
+	const Reg qw = Lanes::load(locals.qw + first);
+
+	const Reg x2 = Lanes::add(qx, qx), y2 = Lanes::add(qy, qy), z2 = Lanes::add(qz, qz);
+	const Reg xx = Lanes::mul(qx, x2), yy = Lanes::mul(qy, y2), zz = Lanes::mul(qz, z2);
+	const Reg xy = Lanes::mul(qx, y2), xz = Lanes::mul(qx, z2), yz = Lanes::mul(qy, z2);
+	const Reg wx = Lanes::mul(qw, x2), wy = Lanes::mul(qw, y2), wz = Lanes::mul(qw, z2);
+
+	// lokalna macierz wezla - kolumny obrotu i przesuniecie
+	const Reg local[4][3] = {
+		{ Lanes::sub(one, Lanes::add(yy, zz)), Lanes::add(xy, wz), Lanes::sub(xz, wy) },
+		{ Lanes::sub(xy, wz), Lanes::sub(one, Lanes::add(xx, zz)), Lanes::add(yz, wx) },
+		{ Lanes::add(xz, wy), Lanes::sub(yz, wx), Lanes::sub(one, Lanes::add(xx, yy)) },
+		{ Lanes::load(locals.x + first), Lanes::load(locals.y + first), Lanes::load(locals.z + first) }
+	};
+
+	// macierze rodzicow (bez ostatniego wiersza, ktory w macierzy afinicznej jest staly)
+	const typename Lanes::Index index = Lanes::index(parents + first);
+
+	Reg parent[4][3];
+	for (int c = 0; c < 4; c++)
+		for (int r = 0; r < 3; r++)
+			parent[c][r] = Lanes::gather(world + 4 * c + r, index);
+
+	float* out = world + 16 * first;
+
+	for (int j = 0; j < 4; j++)
+	{
+		Reg column[3];
+
+		for (int r = 0; r < 3; r++)
+		{
+			column[r] = (j == 3) ? parent[3][r] : zero;
+			column[r] = Lanes::madd(parent[0][r], local[j][0], column[r]);
+			column[r] = Lanes::madd(parent[1][r], local[j][1], column[r]);
+			column[r] = Lanes::madd(parent[2][r], local[j][2], column[r]);
+		}
+
+		Lanes::storeColumns(out + 4 * j, column[0], column[1], column[2], (j == 3) ? one : zero);
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja dodaje przyspieszenia (bez stalej grawitacji) wywolane przez zrodla - srodki
+** masy wezlow lub ciala - do przyspieszen cial grupy; odwrotnosc pierwiastka liczona jest
+** instrukcja przyblizona z jednym krokiem metody Newtona
+** sources - polozenia (xyz) i masy (w) zrodel, 4 liczby na zrodlo
+** count - liczba zrodel
+** groupSize - liczba cial grupy (wielokrotnosc Lanes::WIDTH)
+** x, y, z - polozenia cial grupy
+** softening2 - kwadrat odleglosci wygladzania
+** ax, ay, az - przyspieszenia cial grupy
+**------------------------------------------------------------------------------------------*/
+template <typename Lanes>
+void accumulateGroup(const float* sources, int count, int groupSize, const float* x, const float* y, const float* z, float softening2,
+	float* ax, float* ay, float* az)
+{
+	typedef typename Lanes::Reg Reg;
+
+	const Reg half = Lanes::set1(0.5f);
+	const Reg threeHalves = Lanes::set1(1.5f);
+	const Reg epsilon2 = Lanes::set1(softening2);
+
+	for (int k = 0; k < groupSize; k += Lanes::WIDTH)
+	{
+		const Reg px = Lanes::load(x + k), py = Lanes::load(y + k), pz = Lanes::load(z + k);
+		Reg sumX = Lanes::load(ax + k), sumY = Lanes::load(ay + k), sumZ = Lanes::load(az + k);
+
+		for (int s = 0; s < count; s++)
+		{
+			const float* source = sources + 4 * s;
+
+			const Reg dx = Lanes::sub(Lanes::set1(source[0]), px);
+			const Reg dy = Lanes::sub(Lanes::set1(source[1]), py);
+			const Reg dz = Lanes::sub(Lanes::set1(source[2]), pz);
+			const Reg distance2 = Lanes::madd(dx, dx, Lanes::madd(dy, dy, Lanes::madd(dz, dz, epsilon2)));
+
+			Reg inverse = Lanes::rsqrtApprox(distance2);
+			inverse = Lanes::mul(inverse, Lanes::sub(threeHalves, Lanes::mul(Lanes::mul(half, distance2), Lanes::mul(inverse, inverse))));
+
+			const Reg strength = Lanes::mul(Lanes::set1(source[3]), Lanes::mul(inverse, Lanes::mul(inverse, inverse)));
+			sumX = Lanes::madd(dx, strength, sumX);
+			sumY = Lanes::madd(dy, strength, sumY);
+			sumZ = Lanes::madd(dz, strength, sumZ);
+		}
+
+		Lanes::store(ax + k, sumX);
+		Lanes::store(ay + k, sumY);
+		Lanes::store(az + k, sumZ);
+	}
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja testuje sfery z ostroslupem (testSpheres w culling.cpp) - Lanes::WIDTH sfer
+** naraz, a wyniki porownan z kazda plaszczyzna zbierane sa w maskach bitowych
+** planes - szesc plaszczyzn (x, y, z, w)
+** x, y, z - srodki sfer
+** radius - promienie sfer
+** count - liczba sfer (testowane sa pelne rejestry)
+** results - wyniki testow (CullResult)
+**------------------------------------------------------------------------------------------*/
+template <typename Lanes>
+int testSphereBlocks(const float* planes, const float* x, const float* y, const float* z, const float* radius, int count, std::uint8_t* results)
+{
+	typedef typename Lanes::Reg Reg;
+
+	const Reg zero = Lanes::set1(0.0f);
+	int first = 0;
+
+	for (; first + Lanes::WIDTH <= count; first += Lanes::WIDTH)
+	{
+		const Reg cx = Lanes::load(x + first), cy = Lanes::load(y + first), cz = Lanes::load(z + first);
+		const Reg r = Lanes::load(radius + first);
+		const Reg negativeR = Lanes::sub(zero, r);
+
+		int outside = 0;
+		int intersect = 0;
+
+		for (int p = 0; p < 6; p++)
+		{
+			const float* plane = planes + 4 * p;
+			const Reg distance = Lanes::madd(Lanes::set1(plane[0]), cx, Lanes::madd(Lanes::set1(plane[1]), cy, Lanes::madd(Lanes::set1(plane[2]), cz, Lanes::set1(plane[3]))));
+			outside |= Lanes::lessMask(distance, negativeR);
+			intersect |= Lanes::lessMask(distance, r);
+		}
+
+		for (int k = 0; k < Lanes::WIDTH; k++)
+			results[first + k] = (outside >> k & 1) ? CULL_OUTSIDE : (intersect >> k & 1) ? CULL_INTERSECT : CULL_INSIDE;
+	}
+
+	return first;
+}
+
+#endif /* __SIMDKERNELS_H__ */
@@ -0,0 +1,44 @@
+#include "simd.h"
+
+#if defined(SIMD_X86)
+#include <emmintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC target("sse2")
+#endif
+
+#include "simdkernels.h"
+
+/*------------------------------------------------------------------------------------------
+** operacje na rejestrach SSE2 (4 elementy) - zestaw dostepny na kazdym procesorze x64
+**------------------------------------------------------------------------------------------*/
+struct Sse2Lanes
+{
+	static const int WIDTH = 4;
+
+	typedef __m128 Reg;
+	struct Index { int offsets[4]; }; // SSE nie ma instrukcji gather - elementy ladowane pojedynczo
+
+	static Reg set1(float value) { return _mm_set1_ps(value); }
+	static Reg load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, Reg a) { _mm_storeu_ps(p, a); }
+	static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+	static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+	static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+	static Reg madd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	static Reg rsqrtApprox(Reg a) { return _mm_rsqrt_ps(a); }
+	static int lessMask(Reg a, Reg b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); } // maska bitowa elementow a < b
+	static Index index(const int* parents) { return { { 16 * parents[0], 16 * parents[1], 16 * parents[2], 16 * parents[3] } }; }
+	static Reg gather(const float* base, const Index& index) { return _mm_setr_ps(base[index.offsets[0]], base[index.offsets[1]], base[index.offsets[2]], base[index.offsets[3]]); }
+
+	static void storeColumns(float* out, Reg x, Reg y, Reg z, Reg w) { storeColumns4(out, x, y, z, w); }
+};
+
+const SimdKernels SSE2_KERNELS = { SIMD_SSE2, "SSE2", Sse2Lanes::WIDTH, composeBlock<Sse2Lanes>, accumulateGroup<Sse2Lanes>, testSphereBlocks<Sse2Lanes> };
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
+#endif
@@ -0,0 +1,189 @@
+#include <iostream>
+#include <cstring>
+
+#include "statecache.h"
+
+const char* STATE_CALL_NAMES[] = { "glUseProgram", "glBindVertexArray", "glBindBuffer*", "glPolygonMode", "glLineWidth", "glUniform*" };
+
+/*------------------------------------------------------------------------------------------
+** funkcja zlicza wywolanie
+** call - rodzaj wywolania
+** changed - czy wywolanie zmienia stan (czy trzeba je przekazac do OpenGL)
+** zwraca changed
+**------------------------------------------------------------------------------------------*/
+bool StateCache::count(StateCall call, bool changed)
+{
+	if (changed)
+		issued[call]++;
+	else
+		filtered[call]++;
+
+	return changed;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja porownuje wartosc zmiennej jednorodnej aktualnego programu z zapamietana
+** i zapamietuje nowa
+** location - lokalizacja zmiennej jednorodnej
+** value, size - nowa wartosc i jej rozmiar w bajtach
+**------------------------------------------------------------------------------------------*/
+bool StateCache::uniformChanged(GLint location, const void* value, size_t size)
+{
+	if (currentProgram == UNKNOWN) // nie wiadomo, ktorego programu dotyczy wartosc
+		return true;
+
+	std::vector<unsigned char>& stored = uniforms[(static_cast<GLuint64>(currentProgram) << 32) | static_cast<GLuint>(location)];
+
+	if (stored.size() == size && std::memcmp(stored.data(), value, size) == 0)
+		return false;
+
+	stored.assign(static_cast<const unsigned char*>(value), static_cast<const unsigned char*>(value) + size);
+	return true;
+}
+
+void StateCache::useProgram(GLuint program)
+{
+	if (count(STATE_PROGRAM, program != currentProgram))
+	{
+		glUseProgram(program);
+		currentProgram = program;
+	}
+}
+
+void StateCache::bindVertexArray(GLuint vertexArray)
+{
+	if (count(STATE_VERTEX_ARRAY, vertexArray != currentVertexArray))
+	{
+		glBindVertexArray(vertexArray);
+		currentVertexArray = vertexArray;
+		buffers.erase(GL_ELEMENT_ARRAY_BUFFER); // bufor indeksow jest czescia stanu VAO
+	}
+}
+
+void StateCache::bindBuffer(GLenum target, GLuint buffer)
+{
+	auto bound = buffers.find(target);
+
+	if (count(STATE_BUFFER, bound == buffers.end() || bound->second != buffer))
+	{
+		glBindBuffer(target, buffer);
+		buffers[target] = buffer;
+	}
+}
+
+void StateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	bindBufferRange(target, index, buffer, 0, 0);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja dowiazuje fragment bufora do indeksowanego punktu wiazania (size == 0 - caly
+** bufor, glBindBufferBase); dowiazanie zmienia tez ogolny punkt wiazania celu, wiec jego
+** zapamietana wartosc jest zapominana
+**------------------------------------------------------------------------------------------*/
+void StateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	const GLuint64 key = (static_cast<GLuint64>(target) << 32) | index;
+	auto bound = indexedBuffers.find(key);
+
+	const bool changed = bound == indexedBuffers.end() || bound->second.buffer != buffer || bound->second.offset != offset || bound->second.size != size;
+
+	if (count(STATE_BUFFER, changed))
+	{
+		if (size == 0)
+			glBindBufferBase(target, index, buffer);
+		else
+			glBindBufferRange(target, index, buffer, offset, size);
+
+		indexedBuffers[key] = { buffer, offset, size };
+		buffers.erase(target);
+	}
+}
+
+void StateCache::polygonMode(GLenum mode)
+{
+	if (count(STATE_POLYGON_MODE, mode != currentPolygonMode))
+	{
+		glPolygonMode(GL_FRONT_AND_BACK, mode);
+		currentPolygonMode = mode;
+	}
+}
+
+void StateCache::lineWidth(GLfloat width)
+{
+	if (count(STATE_LINE_WIDTH, width != currentLineWidth))
+	{
+		glLineWidth(width);
+		currentLineWidth = width;
+	}
+}
+
+void StateCache::uniform1i(GLint location, GLint value)
+{
+	if (count(STATE_UNIFORM, uniformChanged(location, &value, sizeof(value))))
+		glUniform1i(location, value);
+}
+
+void StateCache::uniform4fv(GLint location, const GLfloat* value)
+{
+	if (count(STATE_UNIFORM, uniformChanged(location, value, 4 * sizeof(GLfloat))))
+		glUniform4fv(location, 1, value);
+}
+
+void StateCache::uniformMatrix3x2fv(GLint location, GLsizei matrices, const GLfloat* value)
+{
+	if (count(STATE_UNIFORM, uniformChanged(location, value, matrices * 6 * sizeof(GLfloat))))
+		glUniformMatrix3x2fv(location, matrices, GL_FALSE, value);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zapomina caly zapamietany stan - nastepne wywolania nie zostana pominiete
+**------------------------------------------------------------------------------------------*/
+void StateCache::invalidate()
+{
+	currentProgram = UNKNOWN;
+	currentVertexArray = UNKNOWN;
+	currentPolygonMode = UNKNOWN;
+	currentLineWidth = -1.0f;
+	buffers.clear();
+	indexedBuffers.clear();
+	uniforms.clear();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zeruje liczniki wywolan
+**------------------------------------------------------------------------------------------*/
+void StateCache::resetStats()
+{
+	for (int call = 0; call < STATE_CALLS; call++)
+	{
+		issued[call] = 0;
+		filtered[call] = 0;
+	}
+
+	frames = 0;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyswietla liczby wywolan przekazanych do OpenGL i pominietych (srednio na
+** klatke) dla kazdego rodzaju wywolania, ktore wystapilo
+** label - opis wyswietlany przed wynikami
+**------------------------------------------------------------------------------------------*/
+void StateCache::printStats(const char* label) const
+{
+	const double perFrame = (frames > 0) ? 1.0 / frames : 1.0;
+	long long totalIssued = 0, totalFiltered = 0;
+
+	std::cout << label << " (" << frames << " klatek, srednio na klatke):" << std::endl;
+
+	for (int call = 0; call < STATE_CALLS; call++)
+	{
+		totalIssued += issued[call];
+		totalFiltered += filtered[call];
+
+		if (issued[call] + filtered[call] > 0)
+			std::cout << "  " << STATE_CALL_NAMES[call] << ": wyslane " << issued[call] * perFrame << ", pominiete " << filtered[call] * perFrame << std::endl;
+	}
+
+	std::cout << "  razem: wyslane " << totalIssued * perFrame << ", pominiete " << totalFiltered * perFrame << std::endl;
+}
@@ -0,0 +1,149 @@
+#include "transform.h"
+#include "simd.h"
+
+/*------------------------------------------------------------------------------------------
+** funkcja usuwa wszystkie przeksztalcenia
+**------------------------------------------------------------------------------------------*/
+void TransformArrays::clear()
+{
+	x.clear();
+	y.clear();
+	z.clear();
+	qx.clear();
+	qy.clear();
+	qz.clear();
+	qw.clear();
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja rezerwuje miejsce na capacity przeksztalcen
+**------------------------------------------------------------------------------------------*/
+void TransformArrays::reserve(int capacity)
+{
+	x.reserve(capacity);
+	y.reserve(capacity);
+	z.reserve(capacity);
+	qx.reserve(capacity);
+	qy.reserve(capacity);
+	qz.reserve(capacity);
+	qw.reserve(capacity);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja dodaje przeksztalcenie na koncu tablic
+**------------------------------------------------------------------------------------------*/
+void TransformArrays::push(const glm::vec3& translation, const glm::quat& rotation)
+{
+	x.push_back(translation.x);
+	y.push_back(translation.y);
+	z.push_back(translation.z);
+	qx.push_back(rotation.x);
+	qy.push_back(rotation.y);
+	qz.push_back(rotation.z);
+	qw.push_back(rotation.w);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zmienia i-te przeksztalcenie
+**------------------------------------------------------------------------------------------*/
+void TransformArrays::set(int i, const glm::vec3& translation, const glm::quat& rotation)
+{
+	x[i] = translation.x;
+	y[i] = translation.y;
+	z[i] = translation.z;
+	qx[i] = rotation.x;
+	qy[i] = rotation.y;
+	qz[i] = rotation.z;
+	qw[i] = rotation.w;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja zwraca macierz i-tego przeksztalcenia (najpierw obrot, potem przesuniecie)
+**------------------------------------------------------------------------------------------*/
+glm::mat4 TransformArrays::matrix(int i) const
+{
+	const float x2 = qx[i] + qx[i], y2 = qy[i] + qy[i], z2 = qz[i] + qz[i];
+	const float xx = qx[i] * x2, yy = qy[i] * y2, zz = qz[i] * z2;
+	const float xy = qx[i] * y2, xz = qx[i] * z2, yz = qy[i] * z2;
+	const float wx = qw[i] * x2, wy = qw[i] * y2, wz = qw[i] * z2;
+
+	return glm::mat4(
+		1.0f - (yy + zz), xy + wz, xz - wy, 0.0f,
+		xy - wz, 1.0f - (xx + zz), yz + wx, 0.0f,
+		xz + wy, yz - wx, 1.0f - (xx + yy), 0.0f,
+		x[i], y[i], z[i], 1.0f);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja mnozy dwie macierze afiniczne (ostatni wiersz 0, 0, 0, 1) - 36 mnozen zamiast
+** 64 w pelnym iloczynie macierzy 4x4
+**------------------------------------------------------------------------------------------*/
+static glm::mat4 multiplyAffine(const glm::mat4& a, const glm::mat4& b)
+{
+	const glm::vec3 a0(a[0]), a1(a[1]), a2(a[2]);
+	glm::mat4 result;
+
+	for (int j = 0; j < 4; j++)
+		result[j] = glm::vec4(a0 * b[j].x + a1 * b[j].y + a2 * b[j].z, b[j].w);
+
+	result[3] += glm::vec4(glm::vec3(a[3]), 0.0f);
+
+	return result;
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza macierz swiata jednego wezla
+**------------------------------------------------------------------------------------------*/
+static void composeNode(const TransformArrays& locals, const int* parents, int i, glm::mat4* world)
+{
+	const glm::mat4 local = locals.matrix(i);
+	world[i] = (parents[i] < 0) ? local : multiplyAffine(world[parents[i]], local);
+}
+
+/*------------------------------------------------------------------------------------------
+** funkcja wyznacza macierze swiata wezlow uporzadkowanych topologicznie (rodzic przed
+** dzieckiem) - world[i] = world[parents[i]] * T(i) * R(i)
+** bloki wezli, ktorych rodzice leza przed blokiem (np. wezly tego samego poziomu drzewa
+** zapisane jeden po drugim), liczone sa jadrem SIMD najszerszego zestawu instrukcji
+** obslugiwanego przez procesor (simdKernels), a pozostale (korzenie, rodzic w tym samym
+** bloku) po kolei
+** locals - lokalne przesuniecia i obroty
+** parents - indeksy rodzicow (-1 - korzen)
+** first - indeks pierwszego wyznaczanego wezla (macierze wczesniejszych wezlow musza byc
+**         juz policzone)
+** count - liczba wyznaczanych wezlow
+** world - macierze swiata wszystkich wezlow
+**------------------------------------------------------------------------------------------*/
+void composeWorldMatrices(const TransformArrays& locals, const int* parents, int first, int count, glm::mat4* world)
+{
+	const int last = first + count;
+	int i = first;
+
+	const SimdKernels* kernels = simdKernels();
+
+	if (kernels)
+	{
+		const LocalTransforms pointers = { locals.x.data(), locals.y.data(), locals.z.data(), locals.qx.data(), locals.qy.data(), locals.qz.data(), locals.qw.data() };
+		const int width = kernels->width;
+
+		for (; i + width <= last; i += width)
+		{
+			bool independent = true;
+			for (int k = 0; k < width; k++)
+				independent = independent && parents[i + k] >= 0 && parents[i + k] < i;
+
+			if (independent)
+			{
+				kernels->composeBlock(pointers, parents, i, &world[0][0][0]);
+			}
+			else
+			{
+				for (int k = 0; k < width; k++)
+					composeNode(locals, parents, i + k, world);
+			}
+		}
+	}
+
+	for (; i < last; i++)
+		composeNode(locals, parents, i, world);
+}
@@ -0,0 +1,29 @@
+#ifndef __TRANSFORM_H__
+#define __TRANSFORM_H__
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+
+/*------------------------------------------------------------------------------------------
+** lokalne przesuniecia i obroty wielu obiektow w ukladzie SoA - kazda skladowa w osobnej
+** tablicy, wiec kolejne obiekty ladowane sa do rejestrow SIMD bez przestawiania danych
+**------------------------------------------------------------------------------------------*/
+struct TransformArrays
+{
+	std::vector<float> x, y, z; // przesuniecie
+	std::vector<float> qx, qy, qz, qw; // obrot (kwaternion jednostkowy)
+
+	int size() const { return static_cast<int>(x.size()); }
+
+	void clear();
+	void reserve(int capacity);
+	void push(const glm::vec3& translation, const glm::quat& rotation);
+	void set(int i, const glm::vec3& translation, const glm::quat& rotation);
+	glm::mat4 matrix(int i) const;
+};
+
+void composeWorldMatrices(const TransformArrays& locals, const int* parents, int first, int count, glm::mat4* world);
+
+#endif /* __TRANSFORM_H__ */